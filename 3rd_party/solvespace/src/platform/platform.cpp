@@ -89,27 +89,33 @@ struct Chunk {
     uint8_t *endptr = nullptr;
 };
 
-static std::list<Chunk> chunks;
-static Chunk *last_chunk = nullptr;
+struct TemporaryArena {
+    std::list<Chunk> chunks;
+    Chunk *last_chunk = nullptr;
+};
+
+// Each thread gets its own arena since expressions are allocated while solving.
+static thread_local TemporaryArena arena;
 
 void *AllocTemporary(size_t size)
 {
-    if(!last_chunk) {
-        last_chunk = &chunks.emplace_back();
+    if(!arena.last_chunk) {
+        arena.last_chunk = &arena.chunks.emplace_back();
     }
     else {
-        if(last_chunk->ptr + size > last_chunk->endptr) {
-            last_chunk = &chunks.emplace_back();
+        if(arena.last_chunk->ptr + size > arena.last_chunk->endptr) {
+            arena.last_chunk = &arena.chunks.emplace_back();
         }
     }
-    auto p = (void*)last_chunk->ptr;
+    auto p = (void*)arena.last_chunk->ptr;
     size += 0x10-(size%0x10); // 16 byte alignment
-    last_chunk->ptr += size;
+    arena.last_chunk->ptr += size;
     return p;
 }
 
 void FreeAllTemporary()
 {
+    auto &chunks = arena.chunks;
     size_t total_size = 0;
     for(auto &chunk:chunks) {
         total_size += chunk.data.size();
@@ -124,7 +130,55 @@ void FreeAllTemporary()
     memset(chunk.data.data(), 0, total_size);
     chunk.ptr = chunk.data.data();
     chunk.endptr = chunk.ptr + chunk.data.size();
-    last_chunk = &chunk;
+    arena.last_chunk = &chunk;
+}
+
+TemporaryMark MarkTemporary()
+{
+    TemporaryMark mark = {};
+    mark.chunks = arena.chunks.size();
+    if(arena.last_chunk)
+        mark.offset = arena.last_chunk->ptr - arena.last_chunk->data.data();
+    return mark;
+}
+
+void FreeTemporaryToMark(const TemporaryMark &mark)
+{
+    auto &chunks = arena.chunks;
+    while(chunks.size() > mark.chunks) {
+        chunks.pop_back();
+    }
+    if(chunks.size() == 0) {
+        arena.last_chunk = nullptr;
+        return;
+    }
+    // Allocations are expected to be zeroed
+    auto &chunk = chunks.back();
+    uint8_t *ptr = chunk.data.data() + mark.offset;
+    memset(ptr, 0, chunk.ptr - ptr);
+    chunk.ptr = ptr;
+    arena.last_chunk = &chunk;
+}
+
+TemporaryArena *DetachTemporary()
+{
+    auto detached = new TemporaryArena;
+    detached->chunks.swap(arena.chunks);
+    detached->last_chunk = arena.last_chunk;
+    arena.last_chunk = nullptr;
+    return detached;
+}
+
+void AttachTemporary(TemporaryArena *attached)
+{
+    arena.chunks.swap(attached->chunks);
+    arena.last_chunk = attached->last_chunk;
+    delete attached;
+}
+
+void FreeTemporaryArena(TemporaryArena *detached)
+{
+    delete detached;
 }
 
 }
@@ -81,6 +81,24 @@ void DebugPrint(const char *fmt, ...);
 void *AllocTemporary(size_t size);
 void FreeAllTemporary();
 
+// Everything allocated after taking a mark can be released by rewinding to it,
+// while earlier allocations stay valid.
+struct TemporaryMark {
+    size_t chunks;
+    size_t offset;
+};
+TemporaryMark MarkTemporary();
+void FreeTemporaryToMark(const TemporaryMark &mark);
+
+// Detaching hands the calling thread's arena to the caller and leaves the
+// thread with an empty one. Attaching makes a detached arena current again,
+// discarding the current one. This is used for keeping the expressions of a
+// solver session alive between solves.
+struct TemporaryArena;
+TemporaryArena *DetachTemporary();
+void AttachTemporary(TemporaryArena *arena);
+void FreeTemporaryArena(TemporaryArena *arena);
+
 } // namespace Platform
 } // namespace SolveSpace
 
@@ -225,6 +225,10 @@ public:
     // we should put as close as possible to their initial positions.
     List<hParam>                    dragged;
 
+    // Set if eq already holds all equations to solve, e.g. when solving
+    // only a subset of a group's equations.
+    bool                            equationsWritten = false;
+
     enum {
         // In general, the tag indicates the subsys that a variable/equation
         // has been assigned to; these are exceptions for variables:
@@ -823,7 +827,8 @@ bool LinkIDF(const Platform::Path &filename, EntityList *le, SMesh *m, SShell *s
 bool LinkStl(const Platform::Path &filename, EntityList *le, SMesh *m, SShell *sh);
 
 extern SolveSpaceUI SS;
-extern Sketch SK;
+// Per-thread so that independent solves can run concurrently.
+extern thread_local Sketch SK;
 
 }
 
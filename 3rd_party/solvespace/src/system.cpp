@@ -568,7 +568,8 @@ static void add_expr(Expr *e, Equation *eq,
 
 SolveResult System::Solve(Group *g, int *rank, int *dof, List<hConstraint> *bad, bool andFindBad,
                           bool andFindFree, bool forceDofCheck) {
-    WriteEquationsExceptFor(Constraint::NO_CONSTRAINT, g);
+    if(!equationsWritten)
+        WriteEquationsExceptFor(Constraint::NO_CONSTRAINT, g);
 
     bool rankOk;
 
@@ -0,0 +1,708 @@
+#include "document/document.hpp"
+#include "document/entity/entity_line2d.hpp"
+#include "document/constraint/constraint_points_coincident.hpp"
+#include "document/constraint/constraint_hv.hpp"
+#include "document/constraint/constraint_point_distance.hpp"
+#include "document/group/group.hpp"
+#include "document/group/group_extrude.hpp"
+#include "document/group/group_linear_array.hpp"
+#include "document/entity/entity_workplane.hpp"
+#include "canvas/selectable_index.hpp"
+#include "canvas/selectable_ref.hpp"
+#include "util/paths.hpp"
+#include "import_step/step_import_manager.hpp"
+#include "preferences/preferences.hpp"
+#include "system/system.hpp"
+#include "util/task_graph.hpp"
+#include "util/fs_util.hpp"
+#include "util/util.hpp"
+#include "nlohmann/json.hpp"
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <map>
+#include <set>
+#include <streambuf>
+#include <mutex>
+#include <optional>
+#include <thread>
+
+// Headless benchmark for loading and updating documents, prints timings per
+// group as JSON. Documents are either loaded from files or generated, the
+// generated ones make up a synthetic corpus for tracking performance over time.
+// --selectables times the canvas' selectable index on its own.
+
+using namespace dune3d;
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+// Swallows the solver's log output. It gets written from the threads updating
+// groups in parallel, so this mustn't keep any state.
+class NullBuffer : public std::streambuf {
+protected:
+    int overflow(int c) override
+    {
+        return traits_type::not_eof(c);
+    }
+
+    std::streamsize xsputn(const char *, std::streamsize n) override
+    {
+        return n;
+    }
+};
+
+double seconds_since(Clock::time_point start)
+{
+    const std::chrono::duration<double> d = Clock::now() - start;
+    return d.count();
+}
+
+std::string solve_result_to_string(SolveResult r)
+{
+    switch (r) {
+    case SolveResult::OKAY:
+        return "okay";
+    case SolveResult::DIDNT_CONVERGE:
+        return "didnt_converge";
+    case SolveResult::REDUNDANT_OKAY:
+        return "redundant_okay";
+    case SolveResult::REDUNDANT_DIDNT_CONVERGE:
+        return "redundant_didnt_converge";
+    case SolveResult::TOO_MANY_UNKNOWNS:
+        return "too_many_unknowns";
+    }
+    return "unknown";
+}
+
+Group &get_sketch_group(Document &doc)
+{
+    return *doc.get_groups_sorted().at(1);
+}
+
+EntityLine2D &add_line(Document &doc, Group &group, const glm::dvec2 &p1, const glm::dvec2 &p2)
+{
+    auto &line = doc.add_entity<EntityLine2D>(UUID::random());
+    line.m_group = group.m_uuid;
+    line.m_wrkpl = group.m_active_wrkpl;
+    line.m_p1 = p1;
+    line.m_p2 = p2;
+    return line;
+}
+
+template <typename T> T &add_constraint(Document &doc, Group &group)
+{
+    auto &constraint = doc.add_constraint<T>(UUID::random());
+    constraint.m_group = group.m_uuid;
+    return constraint;
+}
+
+void add_hv(Document &doc, Group &group, const EntityLine2D &line, bool horizontal)
+{
+    ConstraintHV *constraint;
+    if (horizontal)
+        constraint = &add_constraint<ConstraintHorizontal>(doc, group);
+    else
+        constraint = &add_constraint<ConstraintVertical>(doc, group);
+    constraint->m_entity1 = {line.m_uuid, 1};
+    constraint->m_entity2 = {line.m_uuid, 2};
+    constraint->m_wrkpl = group.m_active_wrkpl;
+}
+
+void add_length(Document &doc, Group &group, const EntityLine2D &line, double length)
+{
+    auto &constraint = add_constraint<ConstraintPointDistance>(doc, group);
+    constraint.m_entity1 = {line.m_uuid, 1};
+    constraint.m_entity2 = {line.m_uuid, 2};
+    constraint.m_wrkpl = group.m_active_wrkpl;
+    constraint.m_distance = length;
+}
+
+void add_coincident(Document &doc, Group &group, const EntityAndPoint &a, const EntityAndPoint &b)
+{
+    auto &constraint = add_constraint<ConstraintPointsCoincident>(doc, group);
+    constraint.m_entity1 = a;
+    constraint.m_entity2 = b;
+    constraint.m_wrkpl = group.m_active_wrkpl;
+}
+
+// n unconnected lines, each one is a small independent system
+void generate_lines(Document &doc, unsigned int n)
+{
+    auto &group = get_sketch_group(doc);
+    for (unsigned int i = 0; i < n; i++) {
+        auto &line = add_line(doc, group, glm::dvec2(i * 2., 0), glm::dvec2(i * 2. + 1, .2));
+        add_hv(doc, group, line, true);
+        add_length(doc, group, line, 1.5);
+    }
+}
+
+// n lines connected end to end, making up one large system
+void generate_chain(Document &doc, unsigned int n)
+{
+    auto &group = get_sketch_group(doc);
+    const EntityLine2D *last = nullptr;
+    for (unsigned int i = 0; i < n; i++) {
+        auto &line = add_line(doc, group, glm::dvec2(i, (i % 2) * .1), glm::dvec2(i + 1., ((i + 1) % 2) * .1));
+        add_hv(doc, group, line, true);
+        add_length(doc, group, line, 1.5);
+        if (last)
+            add_coincident(doc, group, {last->m_uuid, 2}, {line.m_uuid, 1});
+        last = &line;
+    }
+}
+
+// a constrained rectangle, extruded and arrayed n times
+void generate_array(Document &doc, unsigned int n)
+{
+    auto &sketch = get_sketch_group(doc);
+    const std::array<glm::dvec2, 4> corners = {{{0, 0}, {1, 0}, {1, 1}, {0, 1}}};
+    std::vector<EntityLine2D *> lines;
+    for (size_t i = 0; i < corners.size(); i++) {
+        lines.push_back(&add_line(doc, sketch, corners.at(i), corners.at((i + 1) % corners.size())));
+    }
+    for (size_t i = 0; i < lines.size(); i++) {
+        add_coincident(doc, sketch, {lines.at(i)->m_uuid, 2}, {lines.at((i + 1) % lines.size())->m_uuid, 1});
+        add_hv(doc, sketch, *lines.at(i), i % 2 == 0);
+    }
+    add_length(doc, sketch, *lines.at(0), 2);
+    add_length(doc, sketch, *lines.at(1), 1);
+
+    auto &extrude = doc.insert_group<GroupExtrude>(UUID::random(), sketch.m_uuid);
+    extrude.m_name = doc.find_next_group_name(extrude.get_type());
+    extrude.m_wrkpl = sketch.m_active_wrkpl;
+    extrude.m_dvec = doc.get_entity<EntityWorkplane>(extrude.m_wrkpl).get_normal_vector();
+    extrude.m_source_group = sketch.m_uuid;
+
+    auto &array = doc.insert_group<GroupLinearArray>(UUID::random(), extrude.m_uuid);
+    array.m_name = doc.find_next_group_name(array.get_type());
+    array.m_source_group = extrude.m_uuid;
+    array.m_count = n;
+    array.m_dvec = {3, 0, 0};
+}
+
+// n closed polygons made of unconstrained lines, as traced or imported outlines
+// end up, for timing how long it takes to find their paths
+void generate_contours(Document &doc, unsigned int n)
+{
+    auto &group = get_sketch_group(doc);
+    constexpr unsigned int n_segments = 16;
+    const auto n_columns = static_cast<unsigned int>(std::ceil(std::sqrt(n)));
+    for (unsigned int i = 0; i < n; i++) {
+        const glm::dvec2 center((i % n_columns) * 3., (i / n_columns) * 3.);
+        auto get_pt = [&center](unsigned int j) {
+            const auto phi = (j % n_segments) * 2 * M_PI / n_segments;
+            return center + glm::dvec2(std::cos(phi), std::sin(phi));
+        };
+        for (unsigned int j = 0; j < n_segments; j++) {
+            // end points are a bit off, as they would be without coincident constraints
+            add_line(doc, group, get_pt(j), get_pt(j + 1) + glm::dvec2(1e-9, 0));
+        }
+    }
+}
+
+std::optional<Document> generate(const std::string &kind, unsigned int n)
+{
+    Document doc;
+    if (kind == "lines")
+        generate_lines(doc, n);
+    else if (kind == "chain")
+        generate_chain(doc, n);
+    else if (kind == "array")
+        generate_array(doc, n);
+    else if (kind == "contours")
+        generate_contours(doc, n);
+    else
+        return {};
+    return doc;
+}
+
+class StepTimes {
+public:
+    void add(const Group &group, Document::UpdateStep step, double seconds)
+    {
+        std::lock_guard<std::mutex> guard{m_mutex};
+        auto &times = m_times[group.m_uuid];
+        switch (step) {
+        case Document::UpdateStep::GENERATE:
+            times.generate += seconds;
+            break;
+        case Document::UpdateStep::SOLVE:
+            times.solve += seconds;
+            break;
+        case Document::UpdateStep::UPDATE_SOLID_MODEL:
+            times.solid_model += seconds;
+            break;
+        }
+    }
+
+    struct Times {
+        double generate = 0;
+        double solve = 0;
+        double solid_model = 0;
+    };
+
+    Times get(const UUID &group) const
+    {
+        if (m_times.contains(group))
+            return m_times.at(group);
+        return {};
+    }
+
+private:
+    std::mutex m_mutex;
+    std::map<UUID, Times> m_times;
+};
+
+json run_update(Document &doc)
+{
+    StepTimes step_times;
+    doc.set_update_step_callback([&step_times](const Group &group, Document::UpdateStep step, double seconds) {
+        step_times.add(group, step, seconds);
+    });
+    doc.set_group_generate_pending(doc.get_groups_sorted().front()->m_uuid);
+    const auto t_start = Clock::now();
+    doc.update_pending();
+    const auto t_update = seconds_since(t_start);
+    doc.set_update_step_callback(nullptr);
+
+    json j;
+    j["update_seconds"] = t_update;
+    j["n_entities"] = doc.m_entities.size();
+    j["n_constraints"] = doc.m_constraints.size();
+    auto groups = json::array();
+    for (const auto group : doc.get_groups_sorted()) {
+        const auto times = step_times.get(group->m_uuid);
+        groups.push_back({
+                {"uuid", (std::string)group->m_uuid},
+                {"name", group->m_name},
+                {"type", group->get_type_name()},
+                {"generate_seconds", times.generate},
+                {"solve_seconds", times.solve},
+                {"solid_model_seconds", times.solid_model},
+                {"dof", group->m_dof},
+                {"solve_result", solve_result_to_string(group->m_solve_result)},
+        });
+    }
+    j["groups"] = groups;
+    return j;
+}
+
+// Times finding the closed paths in each group's workplane, as is done
+// before extruding a sketch or exporting it
+json run_paths(const Document &doc)
+{
+    json j;
+    const Document::ItemIndex item_index{doc};
+    const auto t_start = Clock::now();
+    auto groups = json::array();
+    for (const auto group : doc.get_groups_sorted()) {
+        if (!group->m_active_wrkpl)
+            continue;
+        const auto t_group_start = Clock::now();
+        const auto paths = paths::Paths::from_document(doc, group->m_active_wrkpl, group->m_uuid, &item_index);
+        groups.push_back({
+                {"uuid", (std::string)group->m_uuid},
+                {"name", group->m_name},
+                {"seconds", seconds_since(t_group_start)},
+                {"n_paths", paths.paths.size()},
+        });
+    }
+    j["paths_seconds"] = seconds_since(t_start);
+    j["groups"] = groups;
+    return j;
+}
+
+// Updates one copy of the document serially and one in parallel. Updating in
+// parallel must not change the result, so both need to be identical.
+json check_parallel(const Document &doc)
+{
+    auto update = [&doc](Document::UpdateMode mode) {
+        Document copy{doc};
+        const auto mode_before = Document::get_update_mode();
+        Document::set_update_mode(mode);
+        copy.set_group_generate_pending(copy.get_groups_sorted().front()->m_uuid);
+        copy.update_pending();
+        Document::set_update_mode(mode_before);
+
+        json j = copy.serialize();
+        for (const auto group : copy.get_groups_sorted()) {
+            j["results"][(std::string)group->m_uuid] = {
+                    {"dof", group->m_dof},
+                    {"solve_result", solve_result_to_string(group->m_solve_result)},
+                    {"messages", group->get_messages().size()},
+            };
+        }
+        return j;
+    };
+    const auto j_serial = update(Document::UpdateMode::SERIAL);
+    const auto j_parallel = update(Document::UpdateMode::PARALLEL);
+
+    json j;
+    j["identical"] = j_serial == j_parallel;
+    if (j_serial != j_parallel) {
+        auto paths = json::array();
+        for (const auto &op : json::diff(j_serial, j_parallel)) {
+            paths.push_back(op.at("path"));
+        }
+        j["differences"] = paths;
+    }
+    return j;
+}
+
+// Solves all groups of copies of the document on several threads at once. Each
+// thread has its own solver state, so every copy needs to end up the same as
+// when solving on a single thread.
+json stress_solve(const Document &doc, unsigned int n_solves)
+{
+    Document updated{doc};
+    updated.set_group_generate_pending(updated.get_groups_sorted().front()->m_uuid);
+    updated.update_pending();
+
+    auto solve = [&updated] {
+        Document copy{updated};
+        json j;
+        for (const auto group : copy.get_groups_sorted()) {
+            if (group->get_type() == Group::Type::REFERENCE)
+                continue;
+            System system{copy, group->m_uuid};
+            const auto res = system.solve();
+            system.update_document();
+            j["results"][(std::string)group->m_uuid] = {{"dof", res.dof},
+                                                        {"solve_result", solve_result_to_string(res.result)}};
+        }
+        j["document"] = copy.serialize();
+        return j;
+    };
+
+    const auto reference = solve();
+    const auto n_threads = std::max(TaskGraph::get_default_n_threads(), 2u);
+    std::atomic<unsigned int> n_started = 0;
+    std::atomic<unsigned int> n_mismatches = 0;
+    std::vector<std::thread> threads;
+    const auto t_start = Clock::now();
+    for (unsigned int i = 0; i < n_threads; i++) {
+        threads.emplace_back([&] {
+            while (n_started++ < n_solves) {
+                if (solve() != reference)
+                    n_mismatches++;
+            }
+        });
+    }
+    for (auto &thread : threads) {
+        thread.join();
+    }
+
+    return {
+            {"threads", n_threads},
+            {"solves", n_solves},
+            {"seconds", seconds_since(t_start)},
+            {"mismatches", n_mismatches.load()},
+    };
+}
+
+// Canvas-like workload for SelectableIndex: each entity gets a run of line
+// vertices and an icon per point, as the renderer emits them. The std::map
+// variant is what the canvas used before, as a reference.
+struct SelectableWorkload {
+    using VertexType = ICanvas::VertexType;
+    struct Add {
+        VertexType type;
+        size_t first;
+        size_t count;
+        SelectableRef sr;
+    };
+    std::vector<Add> adds;
+    std::array<size_t, 2> n_vertices = {0, 0};
+    std::set<SelectableRef> selection;
+
+    explicit SelectableWorkload(unsigned int n)
+    {
+        for (unsigned int i = 0; i < n; i++) {
+            const auto uu = UUID::random();
+            add(VertexType::LINE, 8, {SelectableRef::Type::ENTITY, uu, 0});
+            for (unsigned int pt = 1; pt <= 2; pt++)
+                add(VertexType::ICON, 1, {SelectableRef::Type::ENTITY, uu, pt});
+            // every tenth entity is selected, along with its points
+            if (i % 10 == 0) {
+                for (unsigned int pt = 0; pt <= 2; pt++)
+                    selection.insert({SelectableRef::Type::ENTITY, uu, pt});
+            }
+        }
+    }
+
+    static size_t type_index(VertexType type)
+    {
+        return type == VertexType::LINE ? 0 : 1;
+    }
+
+private:
+    void add(VertexType type, size_t count, const SelectableRef &sr)
+    {
+        auto &n = n_vertices.at(type_index(type));
+        adds.push_back({type, n, count, sr});
+        n += count;
+    }
+};
+
+json run_selectable_index(const SelectableWorkload &wl)
+{
+    json j;
+    std::array<std::vector<uint8_t>, 2> flags;
+    for (size_t i = 0; i < flags.size(); i++)
+        flags.at(i).resize(wl.n_vertices.at(i));
+
+    SelectableIndex index;
+    auto t_start = Clock::now();
+    for (const auto &add : wl.adds)
+        index.add(add.type, add.first, add.count, add.sr);
+    j["add_seconds"] = seconds_since(t_start);
+
+    size_t n_found = 0;
+    t_start = Clock::now();
+    for (const auto type : {ICanvas::VertexType::LINE, ICanvas::VertexType::ICON}) {
+        for (size_t i = 0; i < wl.n_vertices.at(SelectableWorkload::type_index(type)); i++) {
+            if (index.find(type, i))
+                n_found++;
+        }
+    }
+    j["lookup_seconds"] = seconds_since(t_start);
+    j["found"] = n_found;
+
+    t_start = Clock::now();
+    for (const auto &sr : wl.selection) {
+        if (auto ranges = index.find_ranges(sr)) {
+            for (const auto &range : *ranges) {
+                auto &f = flags.at(SelectableWorkload::type_index(range.type));
+                for (size_t i = 0; i < range.count; i++)
+                    f.at(range.first + i) |= 1;
+            }
+        }
+    }
+    j["flags_seconds"] = seconds_since(t_start);
+    return j;
+}
+
+json run_selectable_map(const SelectableWorkload &wl)
+{
+    using VertexRef = ICanvas::VertexRef;
+    json j;
+    std::array<std::vector<uint8_t>, 2> flags;
+    for (size_t i = 0; i < flags.size(); i++)
+        flags.at(i).resize(wl.n_vertices.at(i));
+
+    std::map<VertexRef, SelectableRef> vertex_to_selectable;
+    std::map<SelectableRef, std::vector<VertexRef>> selectable_to_vertices;
+    auto t_start = Clock::now();
+    for (const auto &add : wl.adds) {
+        for (size_t i = 0; i < add.count; i++) {
+            const VertexRef vref{add.type, add.first + i, 0};
+            vertex_to_selectable.emplace(vref, add.sr);
+            selectable_to_vertices[add.sr].push_back(vref);
+        }
+    }
+    j["add_seconds"] = seconds_since(t_start);
+
+    size_t n_found = 0;
+    t_start = Clock::now();
+    for (const auto type : {ICanvas::VertexType::LINE, ICanvas::VertexType::ICON}) {
+        for (size_t i = 0; i < wl.n_vertices.at(SelectableWorkload::type_index(type)); i++) {
+            if (vertex_to_selectable.contains({type, i, 0}))
+                n_found++;
+        }
+    }
+    j["lookup_seconds"] = seconds_since(t_start);
+    j["found"] = n_found;
+
+    t_start = Clock::now();
+    for (const auto &sr : wl.selection) {
+        if (auto it = selectable_to_vertices.find(sr); it != selectable_to_vertices.end()) {
+            for (const auto &vref : it->second)
+                flags.at(SelectableWorkload::type_index(vref.type)).at(vref.index) |= 1;
+        }
+    }
+    j["flags_seconds"] = seconds_since(t_start);
+    return j;
+}
+
+json bench_selectables(unsigned int n, unsigned int repeat)
+{
+    const SelectableWorkload wl(n);
+    json j = {{"selectables", n}};
+    auto runs = json::array();
+    for (unsigned int i = 0; i < repeat; i++) {
+        runs.push_back({{"index", run_selectable_index(wl)}, {"map", run_selectable_map(wl)}});
+    }
+    j["runs"] = runs;
+    return j;
+}
+
+void print_usage(const char *prog)
+{
+    std::cerr << "usage: " << prog << " [options] file.d3ddoc...\n"
+              << "       " << prog << " [options] --generate lines|chain|array|contours N [--save file.d3ddoc]\n"
+              << "       " << prog << " [--repeat N] --selectables N\n"
+              << "options:\n"
+              << "  --repeat N  update each document N times\n"
+              << "  --serial    don't update groups in parallel\n"
+              << "  --check-parallel  check that updating in parallel gives the same result as serially\n"
+              << "  --stress-solve N  solve N copies concurrently and compare them to solving serially\n"
+              << "  --verbose   don't suppress log output of the solver\n";
+}
+
+} // namespace
+
+const Preferences &Preferences::get()
+{
+    static Preferences the_preferences;
+    return the_preferences;
+}
+
+int main(int argc, char *argv[])
+{
+    std::vector<std::string> filenames;
+    std::string generate_kind;
+    unsigned int generate_n = 0;
+    std::string save_filename;
+    unsigned int repeat = 1;
+    bool verbose = false;
+    bool check = false;
+    unsigned int stress_solves = 0;
+    unsigned int n_selectables = 0;
+
+    for (int i = 1; i < argc; i++) {
+        const std::string arg = argv[i];
+        auto next_arg = [&]() -> std::string {
+            if (i + 1 >= argc) {
+                print_usage(argv[0]);
+                exit(1);
+            }
+            return argv[++i];
+        };
+        if (arg == "--generate") {
+            generate_kind = next_arg();
+            generate_n = std::stoul(next_arg());
+        }
+        else if (arg == "--save") {
+            save_filename = next_arg();
+        }
+        else if (arg == "--repeat") {
+            repeat = std::max(1ul, std::stoul(next_arg()));
+        }
+        else if (arg == "--serial") {
+            Document::set_update_mode(Document::UpdateMode::SERIAL);
+        }
+        else if (arg == "--check-parallel") {
+            check = true;
+        }
+        else if (arg == "--stress-solve") {
+            stress_solves = std::stoul(next_arg());
+        }
+        else if (arg == "--selectables") {
+            n_selectables = std::stoul(next_arg());
+        }
+        else if (arg == "--verbose") {
+            verbose = true;
+        }
+        else if (arg == "--help" || arg == "-h") {
+            print_usage(argv[0]);
+            return 0;
+        }
+        else if (arg.starts_with("--")) {
+            print_usage(argv[0]);
+            return 1;
+        }
+        else {
+            filenames.push_back(arg);
+        }
+    }
+    if (n_selectables) {
+        // doesn't involve documents, just the canvas' selectable index
+        if (filenames.size() || generate_kind.size()) {
+            print_usage(argv[0]);
+            return 1;
+        }
+        std::cout << json::array({bench_selectables(n_selectables, repeat)}).dump(4) << std::endl;
+        return 0;
+    }
+    if (filenames.empty() == generate_kind.empty()) {
+        print_usage(argv[0]);
+        return 1;
+    }
+
+    // the solver logs to stdout, which is where our results go
+    // static, since worker threads and exit handlers may still use std::cout after main returns
+    static NullBuffer log_sink;
+    std::ostream json_out{std::cout.rdbuf()};
+    if (!verbose)
+        std::cout.rdbuf(&log_sink);
+
+    int rc = 0;
+    auto bench = [&](Document &doc, json &j) {
+        if (check) {
+            j["check_parallel"] = check_parallel(doc);
+            if (!j["check_parallel"].at("identical").get<bool>())
+                rc = 1;
+        }
+        if (stress_solves) {
+            j["stress_solve"] = stress_solve(doc, stress_solves);
+            if (j["stress_solve"].at("mismatches").get<unsigned int>())
+                rc = 1;
+        }
+        auto runs = json::array();
+        for (unsigned int i = 0; i < repeat; i++) {
+            runs.push_back(run_update(doc));
+        }
+        j["runs"] = runs;
+        auto paths_runs = json::array();
+        for (unsigned int i = 0; i < repeat; i++) {
+            paths_runs.push_back(run_paths(doc));
+        }
+        j["paths_runs"] = paths_runs;
+    };
+
+    auto results = json::array();
+    if (generate_kind.size()) {
+        json j = {{"generate", generate_kind}, {"n", generate_n}};
+        const auto t_start = Clock::now();
+        auto doc = generate(generate_kind, generate_n);
+        if (!doc) {
+            std::cerr << "unknown kind " << generate_kind << std::endl;
+            return 1;
+        }
+        j["generate_seconds"] = seconds_since(t_start);
+        bench(*doc, j);
+        if (save_filename.size())
+            save_json_to_file(path_from_string(save_filename), doc->serialize());
+        results.push_back(j);
+    }
+    for (const auto &filename : filenames) {
+        json j = {{"file", filename}};
+        try {
+            const auto t_start = Clock::now();
+            auto doc = Document::new_from_file(path_from_string(filename));
+            // so that all runs include the same STEP shapes
+            STEPImportManager::get().wait_for_imports();
+            if (doc.set_step_solid_models_pending())
+                doc.update_pending();
+            j["load_seconds"] = seconds_since(t_start);
+            bench(doc, j);
+        }
+        catch (const std::exception &e) {
+            j["error"] = e.what();
+            rc = 1;
+        }
+        results.push_back(j);
+    }
+
+    // documents with STEP entities may have started importing in the background
+    STEPImportManager::get().shutdown();
+    TaskGraph::shutdown_threads();
+
+    json_out << results.dump(4) << std::endl;
+    return rc;
+}
@@ -10,6 +10,9 @@
 #include "iselection_filter.hpp"
 #include <iostream>
 #include <format>
+#include <algorithm>
+#include <limits>
+#include <cstring>
 #include <glm/gtc/matrix_transform.hpp>
 #include <glm/gtx/matrix_transform_2d.hpp>
 #include <glm/gtx/rotate_vector.hpp>
@@ -413,6 +416,7 @@ void Canvas::handle_click_release()
 
 void Canvas::update_drag_selection(glm::vec2 pos)
 {
+    update_pick_buf(get_full_pick_region(), get_full_pick_region());
     m_box_selection.set_box(m_drag_selection_start, pos);
     const auto a = glm::min(m_drag_selection_start, pos);
     const auto b = glm::max(m_drag_selection_start, pos);
@@ -697,21 +701,41 @@ glm::quat Canvas::get_tilt_snapped_quat(const glm::quat &q) const
     return best_q;
 }
 
-Canvas::VertexRef Canvas::get_vertex_ref_for_pick(unsigned int pick) const
+void Canvas::update_pick_ranges()
 {
+    m_pick_ranges.clear();
+    m_pick_ranges.reserve(m_vertex_type_picks.size());
     for (const auto &[key, it] : m_vertex_type_picks) {
-        if ((pick >= it.offset) && ((pick - it.offset) < it.count))
-            return {key.first, pick - it.offset, key.second};
+        if (it.count)
+            m_pick_ranges.push_back({it.offset, it.count, key.first, key.second});
+    }
+    std::ranges::sort(m_pick_ranges, {}, &PickRange::offset);
+}
+
+Canvas::VertexRef Canvas::get_vertex_ref_for_pick(unsigned int pick) const
+{
+    // ranges don't overlap, so the only candidate is the last one starting at or before the pick
+    auto it = std::ranges::upper_bound(m_pick_ranges, pick, {}, &PickRange::offset);
+    if (it != m_pick_ranges.begin()) {
+        --it;
+        if (pick - it->offset < it->count)
+            return {it->type, pick - it->offset, it->chunk};
     }
     throw std::runtime_error(std::format("pick {} not found", pick));
 }
 
+const SelectableRef *Canvas::find_selectable_for_vertex_ref(const VertexRef &vref) const
+{
+    if (vref.chunk >= m_chunks.size())
+        return nullptr;
+    return m_chunks.at(vref.chunk).m_selectables.find(vref.type, vref.index);
+}
+
 std::optional<SelectableRef> Canvas::get_selectable_ref_for_vertex_ref(const VertexRef &vref) const
 {
-    if (m_vertex_to_selectable_map.contains(vref)) {
-        auto sr = m_vertex_to_selectable_map.at(vref);
-        if (!m_selection_filter || m_selection_filter->can_select(sr))
-            return sr;
+    if (auto sr = find_selectable_for_vertex_ref(vref)) {
+        if (!m_selection_filter || m_selection_filter->can_select(*sr))
+            return *sr;
         else
             return {};
     }
@@ -734,11 +758,11 @@ void Canvas::clear_flags(VertexFlags mask)
     }
 }
 
-unsigned int Canvas::get_hover_pick(const std::vector<pick_buf_t> &pick_buf) const
+unsigned int Canvas::get_hover_pick(const PickBuffer &pick_buf) const
 {
     auto pick = read_pick_buf(pick_buf, m_last_x, m_last_y);
     if (!pick || any_of(get_vertex_ref_for_pick(pick).type, VertexType::FACE_GROUP, VertexType::PICTURE)) {
-        int box_size = 10;
+        const int box_size = s_hover_box_size;
         float best_distance = glm::vec2(box_size, box_size).length();
         unsigned int best_pick = pick;
         for (int dx = -box_size; dx <= box_size; dx++) {
@@ -776,6 +800,7 @@ void Canvas::update_hover_selection()
     if (m_selection_mode != SelectionMode::NONE) {
         auto last_hover_selection = m_hover_selection;
         m_hover_selection.reset();
+        update_pick_buf(get_hover_pick_region(0), get_hover_pick_region(s_hover_pick_margin));
         auto pick = get_hover_pick();
 
         if (auto sr = get_selectable_ref_for_pick(pick))
@@ -788,12 +813,8 @@ void Canvas::update_hover_selection()
                 mask |= VertexFlags::SELECTED;
             }
             clear_flags(mask);
-            if (m_hover_selection.has_value()) {
-                for (const auto &vref : m_selectable_to_vertex_map.at(m_hover_selection.value())) {
-                    auto &flags = get_vertex_flags(vref);
-                    flags |= mask;
-                }
-            }
+            if (m_hover_selection.has_value())
+                set_flags_for_selectable(m_hover_selection.value(), mask);
             m_push_flags =
                     static_cast<PushFlags>(m_push_flags | PF_LINES | PF_GLYPHS | PF_GLYPHS_3D | PF_ICONS | PF_PICTURES);
             queue_draw();
@@ -802,14 +823,123 @@ void Canvas::update_hover_selection()
     }
 }
 
-Canvas::pick_buf_t Canvas::read_pick_buf(const std::vector<pick_buf_t> &pick_buf, int x, int y) const
+bool Canvas::PickRegion::contains(const PickRegion &other) const
+{
+    return other.x >= x && other.y >= y && other.x + other.width <= x + width
+           && other.y + other.height <= y + height;
+}
+
+Canvas::pick_buf_t Canvas::PickBuffer::get(int x, int y) const
+{
+    if (x < region.x || y < region.y || x >= region.x + region.width || y >= region.y + region.height)
+        return 0;
+    return data.at((y - region.y) * region.width + (x - region.x));
+}
+
+Canvas::pick_buf_t Canvas::read_pick_buf(const PickBuffer &pick_buf, int x, int y) const
 {
     int xi = x * m_scale_factor;
     int yi = y * m_scale_factor;
     if (xi >= m_dev_width || yi >= m_dev_height || x < 0 || y < 0)
         return 0;
-    const int idx = ((m_dev_height)-yi - 1) * m_dev_width + xi;
-    return pick_buf.at(idx);
+    return pick_buf.get(xi, (m_dev_height)-yi - 1);
+}
+
+Canvas::PickRegion Canvas::get_full_pick_region() const
+{
+    return {0, 0, m_dev_width, m_dev_height};
+}
+
+Canvas::PickRegion Canvas::get_hover_pick_region(int margin) const
+{
+    // one more pixel to account for rounding of the cursor position
+    const int r = (s_hover_box_size + margin) * m_scale_factor + 1;
+    const int cx = static_cast<int>(m_last_x * m_scale_factor);
+    const int cy = m_dev_height - static_cast<int>(m_last_y * m_scale_factor) - 1;
+    const int x0 = std::clamp(cx - r, 0, m_dev_width);
+    const int x1 = std::clamp(cx + r + 1, 0, m_dev_width);
+    const int y0 = std::clamp(cy - r, 0, m_dev_height);
+    const int y1 = std::clamp(cy + r + 1, 0, m_dev_height);
+    return {x0, y0, x1 - x0, y1 - y0};
+}
+
+Canvas::PickRegion Canvas::get_pick_region_to_read() const
+{
+    // only box selection needs all of the picks
+    if (m_selection_mode == SelectionMode::DRAG)
+        return get_full_pick_region();
+    return get_hover_pick_region(s_hover_pick_margin);
+}
+
+void Canvas::start_pick_readback(const PickRegion &region)
+{
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, m_fbo_downsampled);
+    glReadBuffer(GL_COLOR_ATTACHMENT0);
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, m_pick_pbo);
+    const auto size = region.get_size() * sizeof(pick_buf_t);
+    if (size > m_pick_pbo_size) {
+        glBufferData(GL_PIXEL_PACK_BUFFER, size, nullptr, GL_STREAM_READ);
+        m_pick_pbo_size = size;
+    }
+    glPixelStorei(GL_PACK_ALIGNMENT, 4);
+    glReadPixels(region.x, region.y, region.width, region.height, GL_RED_INTEGER, GL_UNSIGNED_INT, nullptr);
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+    m_pick_pending = region;
+}
+
+void Canvas::finish_pick_readback()
+{
+    if (!m_pick_pending.has_value())
+        return;
+    const auto region = m_pick_pending.value();
+    m_pick_pending.reset();
+
+    make_current();
+    m_pick_buf.region = region;
+    m_pick_buf.data.resize(region.get_size());
+    if (m_pick_buf.data.empty())
+        return;
+
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, m_pick_pbo);
+    const auto size = m_pick_buf.data.size() * sizeof(pick_buf_t);
+    if (auto data = glMapBufferRange(GL_PIXEL_PACK_BUFFER, 0, size, GL_MAP_READ_BIT)) {
+        memcpy(m_pick_buf.data.data(), data, size);
+        glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+    }
+    else {
+        m_pick_buf = {};
+    }
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+}
+
+void Canvas::read_pick_buf_sync(PickBuffer &pick_buf, const PickRegion &region)
+{
+    GLint read_fb;
+    glGetIntegerv(GL_READ_FRAMEBUFFER_BINDING, &read_fb);
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, m_fbo_downsampled);
+    glReadBuffer(GL_COLOR_ATTACHMENT0);
+    pick_buf.region = region;
+    pick_buf.data.resize(region.get_size());
+    glPixelStorei(GL_PACK_ALIGNMENT, 4);
+    glReadPixels(region.x, region.y, region.width, region.height, GL_RED_INTEGER, GL_UNSIGNED_INT,
+                 pick_buf.data.data());
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, read_fb);
+}
+
+void Canvas::update_pick_buf(const PickRegion &needed, const PickRegion &to_read)
+{
+    finish_pick_readback();
+    if (m_pick_buf.region.contains(needed))
+        return;
+    if (m_pick_fbo_peeled) {
+        // the next frame will read them
+        queue_draw();
+        return;
+    }
+    // the cursor moved further than the margin since the last frame or box selection
+    // just started, so read what's needed from the last frame right away
+    make_current();
+    read_pick_buf_sync(m_pick_buf, to_read);
 }
 
 glm::dvec3 Canvas::get_cursor_pos_for_plane(glm::dvec3 origin, glm::dvec3 normal) const
@@ -884,6 +1014,9 @@ void Canvas::on_realize()
     glGenRenderbuffers(1, &m_pickrenderbuffer_downsampled);
     glGenRenderbuffers(1, &m_last_frame_renderbuffer);
     glGenTextures(1, &m_selection_texture);
+    glGenBuffers(1, &m_pick_pbo);
+    m_pick_pbo_size = 0;
+    m_pick_pending.reset();
 
     resize_buffers();
 
@@ -1006,9 +1139,42 @@ ICanvas::VertexRef Canvas::add_face_group(const face::Faces &faces, glm::vec3 or
     m_current_chunk->m_face_groups.push_back(CanvasChunk::FaceGroup{
             .offset = offset,
             .length = length,
-            .origin = origin,
-            .normal = normal,
+            .transform = glm::translate(glm::mat4(1), origin) * glm::toMat4(normal),
+            .color = face_color,
+    });
+
+    return {VertexType::FACE_GROUP, m_current_chunk->m_face_groups.size() - 1, m_current_chunk_id};
+}
+
+ICanvas::VertexRef Canvas::add_face_group_instance(std::shared_ptr<const face::Faces> faces,
+                                                   const glm::mat4 &transform, FaceColor face_color)
+{
+    auto key = faces.get();
+    if (!m_shared_face_meshes.contains(key)) {
+        auto &mesh = m_shared_face_meshes[key];
+        MinMaxAccumulator<float> acc_x, acc_y, acc_z;
+        for (const auto &face : *faces) {
+            for (const auto &v : face.vertices) {
+                acc_x.accumulate(v.x);
+                acc_y.accumulate(v.y);
+                acc_z.accumulate(v.z);
+            }
+            mesh.n_vertices += face.vertices.size();
+            mesh.n_indices += face.triangle_indices.size() * 3;
+        }
+        mesh.bbox.first = {acc_x.get_min(), acc_y.get_min(), acc_z.get_min()};
+        mesh.bbox.second = {acc_x.get_max(), acc_y.get_max(), acc_z.get_max()};
+        mesh.short_indices = mesh.n_vertices <= std::numeric_limits<uint16_t>::max() + 1;
+        mesh.faces = std::move(faces);
+    }
+    const auto &mesh = m_shared_face_meshes.at(key);
+
+    m_current_chunk->m_face_groups.push_back(CanvasChunk::FaceGroup{
+            .offset = 0,
+            .length = mesh.n_indices,
+            .transform = m_state.transform * transform,
             .color = face_color,
+            .shared_mesh = key,
     });
 
     return {VertexType::FACE_GROUP, m_current_chunk->m_face_groups.size() - 1, m_current_chunk_id};
@@ -1080,15 +1246,25 @@ void Canvas::update_mats()
     m_projmat_viewmat_inv = glm::inverse(m_projmat * m_viewmat);
 }
 
-void Canvas::render_all(std::vector<pick_buf_t> &pick_buf)
+void Canvas::render_all(const std::optional<PickRegion> &pick_region)
 {
     glBindFramebuffer(GL_FRAMEBUFFER, m_fbo);
 
+    // if only the picks in a region are needed, nothing else gets rasterized
+    if (pick_region.has_value()) {
+        glEnable(GL_SCISSOR_TEST);
+        glScissor(pick_region->x, pick_region->y, pick_region->width, pick_region->height);
+    }
+
     glClearColor(0, 0, 0, 0);
     glClearDepth(10);
     glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
     GL_CHECK_ERROR
-    {
+    if (pick_region.has_value()) {
+        const std::array<GLenum, 3> bufs = {GL_NONE, GL_COLOR_ATTACHMENT1, GL_NONE};
+        glDrawBuffers(bufs.size(), bufs.data());
+    }
+    else {
         const std::array<GLenum, 3> bufs = {GL_COLOR_ATTACHMENT0, GL_COLOR_ATTACHMENT1, GL_COLOR_ATTACHMENT2};
         glDrawBuffers(bufs.size(), bufs.data());
     }
@@ -1099,6 +1275,7 @@ void Canvas::render_all(std::vector<pick_buf_t> &pick_buf)
     glEnable(GL_DEPTH_TEST);
 
 
+    m_upload_bytes = 0;
     if (m_push_flags != PF_NONE) {
         m_pick_base = 1;
         m_face_renderer.push();
@@ -1107,6 +1284,7 @@ void Canvas::render_all(std::vector<pick_buf_t> &pick_buf)
         m_glyph_3d_renderer.push();
         m_icon_renderer.push();
         m_picture_renderer.push();
+        update_pick_ranges();
     }
     m_push_flags = PF_NONE;
 
@@ -1150,21 +1328,21 @@ void Canvas::render_all(std::vector<pick_buf_t> &pick_buf)
     glBindFramebuffer(GL_READ_FRAMEBUFFER, m_fbo);
     glDrawBuffer(GL_COLOR_ATTACHMENT0);
     glReadBuffer(GL_COLOR_ATTACHMENT1);
-    glBlitFramebuffer(0, 0, m_dev_width, m_dev_height, 0, 0, m_dev_width, m_dev_height, GL_COLOR_BUFFER_BIT,
-                      GL_NEAREST);
+    {
+        const auto region = pick_region.value_or(get_full_pick_region());
+        const auto x1 = region.x + region.width;
+        const auto y1 = region.y + region.height;
+        glBlitFramebuffer(region.x, region.y, x1, y1, region.x, region.y, x1, y1, GL_COLOR_BUFFER_BIT, GL_NEAREST);
+    }
+    glDisable(GL_SCISSOR_TEST);
 
-    glBindFramebuffer(GL_READ_FRAMEBUFFER, m_fbo_downsampled);
-    glReadBuffer(GL_COLOR_ATTACHMENT0);
-    pick_buf.resize(m_dev_width * m_dev_height);
     GL_CHECK_ERROR
-
-    glPixelStorei(GL_PACK_ALIGNMENT, 4);
-    glReadPixels(0, 0, m_dev_width, m_dev_height, GL_RED_INTEGER, GL_UNSIGNED_INT, pick_buf.data());
 }
 
 void Canvas::peel_selection()
 {
-    std::vector<pick_buf_t> pick_buf;
+    update_pick_buf(get_hover_pick_region(0), get_hover_pick_region(s_hover_pick_margin));
+    PickBuffer pick_buf;
     std::vector<unsigned int> peeled_picks;
     for (auto pick = get_hover_pick(m_pick_buf); pick; pick = get_hover_pick(pick_buf)) {
         peeled_picks.push_back(pick);
@@ -1174,7 +1352,12 @@ void Canvas::peel_selection()
         for (auto renderer : m_all_renderers) {
             renderer->set_peeled_picks(peeled_picks);
         }
-        render_all(pick_buf);
+        // only the picks around the cursor matter here, so each pass is cheap
+        // apart from processing the vertices, and they're needed right away
+        const auto region = get_hover_pick_region(0);
+        render_all(region);
+        m_pick_fbo_peeled = true;
+        read_pick_buf_sync(pick_buf, region);
     }
 
     ISelectionMenuCreator::SelectableRefAndVertexTypeList srv_list;
@@ -1294,6 +1477,9 @@ bool Canvas::on_render(const Glib::RefPtr<Gdk::GLContext> &context)
 
     Gtk::GLArea::on_render(context);
 
+    // the last frame's picks, reading them shouldn't stall as that frame is done by now
+    finish_pick_readback();
+
     if (m_needs_resize) {
         resize_buffers();
         m_needs_resize = false;
@@ -1319,7 +1505,12 @@ bool Canvas::on_render(const Glib::RefPtr<Gdk::GLContext> &context)
         for (auto renderer : m_all_renderers) {
             renderer->set_peeled_picks({});
         }
-        render_all(m_pick_buf);
+        render_all();
+        m_pick_fbo_peeled = false;
+        if (m_pick_state == PickState::QUEUED)
+            read_pick_buf_sync(m_pick_buf, get_full_pick_region());
+        else
+            start_pick_readback(get_pick_region_to_read());
     }
 
 
@@ -1329,7 +1520,7 @@ bool Canvas::on_render(const Glib::RefPtr<Gdk::GLContext> &context)
         std::ofstream ofs(m_pick_path.string());
         for (int y = 0; y < m_dev_height; y++) {
             for (int x = 0; x < m_dev_width; x++) {
-                ofs << m_pick_buf.at(x + y * m_dev_width) << " ";
+                ofs << m_pick_buf.get(x, y) << " ";
             }
             ofs << std::endl;
         }
@@ -1404,9 +1595,8 @@ void Canvas::clear()
     for (auto &chunk : m_chunks) {
         chunk.clear();
     }
-    m_selectable_to_vertex_map.clear();
-    m_vertex_to_selectable_map.clear();
     m_vertex_type_picks.clear();
+    m_pick_ranges.clear();
     m_push_flags = PF_ALL;
     queue_draw();
 }
@@ -1420,18 +1610,8 @@ void Canvas::clear_chunks(unsigned int first_chunk)
         chunk_id++;
     }
 
-    for (auto it = m_vertex_to_selectable_map.cbegin(); it != m_vertex_to_selectable_map.cend() /* not hoisted */;
-         /* no increment */) {
-        if (it->first.chunk >= first_chunk) {
-            m_selectable_to_vertex_map.erase(it->second);
-            it = m_vertex_to_selectable_map.erase(it);
-        }
-        else {
-            ++it;
-        }
-    }
-
     m_vertex_type_picks.clear();
+    m_pick_ranges.clear();
     m_push_flags = PF_ALL;
     queue_draw();
 }
@@ -1453,6 +1633,28 @@ ICanvas::VertexRef Canvas::draw_line(glm::vec3 a, glm::vec3 b)
     return {VertexType::LINE, m_current_chunk->m_lines.size() - 1, m_current_chunk_id};
 }
 
+ICanvas::VertexRange Canvas::draw_polylines(std::span<const glm::vec3> points, std::span<const size_t> path_sizes)
+{
+    auto &lines = m_state.selection_invisible ? m_current_chunk->m_lines_selection_invisible : m_current_chunk->m_lines;
+    VertexFlags flags = VertexFlags::DEFAULT;
+    apply_flags(flags);
+    apply_line_flags(flags);
+
+    const auto first = lines.size();
+    size_t offset = 0;
+    for (const auto size : path_sizes) {
+        for (size_t i = 1; i < size; i++) {
+            auto &li = lines.emplace_back(transform_point(points[offset + i - 1]), transform_point(points[offset + i]));
+            li.flags = flags;
+        }
+        offset += size;
+    }
+
+    if (m_state.selection_invisible)
+        return {VertexType::SELECTION_INVISIBLE, 0, 0, 0};
+    return {VertexType::LINE, first, lines.size() - first, m_current_chunk_id};
+}
+
 ICanvas::VertexRef Canvas::draw_screen_line(glm::vec3 a, glm::vec3 b)
 {
     auto &lines = m_state.selection_invisible ? m_current_chunk->m_lines_selection_invisible : m_current_chunk->m_lines;
@@ -1618,8 +1820,31 @@ void Canvas::add_selectable(const VertexRef &vref, const SelectableRef &sref)
     SelectableRef sr = sref;
     if (m_override_selectable.has_value())
         sr = m_override_selectable.value();
-    m_vertex_to_selectable_map.emplace(vref, sr);
-    m_selectable_to_vertex_map[sr].push_back(vref);
+    m_chunks.at(vref.chunk).m_selectables.add(vref.type, vref.index, 1, sr);
+}
+
+void Canvas::add_selectable(const VertexRange &vrange, const SelectableRef &sref)
+{
+    if (vrange.type == VertexType::SELECTION_INVISIBLE || vrange.count == 0)
+        return;
+    SelectableRef sr = sref;
+    if (m_override_selectable.has_value())
+        sr = m_override_selectable.value();
+    m_chunks.at(vrange.chunk).m_selectables.add(vrange.type, vrange.first, vrange.count, sr);
+}
+
+void Canvas::set_flags_for_selectable(const SelectableRef &sr, VertexFlags flags)
+{
+    unsigned int chunk_id = 0;
+    for (auto &chunk : m_chunks) {
+        if (auto ranges = chunk.m_selectables.find_ranges(sr)) {
+            for (const auto &range : *ranges) {
+                for (size_t i = 0; i < range.count; i++)
+                    chunk.get_vertex_flags({range.type, range.first + i, chunk_id}) |= flags;
+            }
+        }
+        chunk_id++;
+    }
 }
 
 Canvas::VertexFlags &Canvas::get_vertex_flags(const VertexRef &vref)
@@ -1643,14 +1868,7 @@ void Canvas::set_flag_for_selectables(const std::set<SelectableRef> &sel, Vertex
 {
     clear_flags(flag);
     for (auto &sr : sel) {
-        if (!m_selectable_to_vertex_map.contains(sr))
-            continue;
-        auto &vrefs = m_selectable_to_vertex_map.at(sr);
-        for (const auto &vref : vrefs) {
-            auto &flags = get_vertex_flags(vref);
-            flags |= flag;
-        }
-        // auto &flags = get_vertex_flags()
+        set_flags_for_selectable(sr, flag);
     }
     m_push_flags = static_cast<PushFlags>(m_push_flags | PF_LINES | PF_GLYPHS | PF_GLYPHS_3D | PF_ICONS | PF_PICTURES);
     queue_draw();
@@ -1660,13 +1878,7 @@ void Canvas::set_hover_selection(const std::optional<SelectableRef> &sr)
 {
     if (!sr.has_value())
         return;
-    if (!m_selectable_to_vertex_map.contains(*sr))
-        return;
-    auto &vrefs = m_selectable_to_vertex_map.at(*sr);
-    for (const auto &vref : vrefs) {
-        auto &flags = get_vertex_flags(vref);
-        flags |= VertexFlags::HOVER;
-    }
+    set_flags_for_selectable(*sr, VertexFlags::HOVER);
 }
 
 std::set<SelectableRef> Canvas::get_selection() const
@@ -1677,43 +1889,43 @@ std::set<SelectableRef> Canvas::get_selection() const
         for (size_t i = 0; i < chunk.m_lines.size(); i++) {
             if ((chunk.m_lines.at(i).flags & VertexFlags::SELECTED) != VertexFlags::DEFAULT) {
                 const VertexRef vref{.type = VertexType::LINE, .index = i, .chunk = chunk_id};
-                if (m_vertex_to_selectable_map.count(vref))
-                    r.insert(m_vertex_to_selectable_map.at(vref));
+                if (auto sr = find_selectable_for_vertex_ref(vref))
+                    r.insert(*sr);
             }
         }
         for (size_t i = 0; i < chunk.m_glyphs.size(); i++) {
             if ((chunk.m_glyphs.at(i).flags & VertexFlags::SELECTED) != VertexFlags::DEFAULT) {
                 const VertexRef vref{.type = VertexType::GLYPH, .index = i, .chunk = chunk_id};
-                if (m_vertex_to_selectable_map.count(vref))
-                    r.insert(m_vertex_to_selectable_map.at(vref));
+                if (auto sr = find_selectable_for_vertex_ref(vref))
+                    r.insert(*sr);
             }
         }
         for (size_t i = 0; i < chunk.m_glyphs_3d.size(); i++) {
             if ((chunk.m_glyphs_3d.at(i).flags & VertexFlags::SELECTED) != VertexFlags::DEFAULT) {
                 const VertexRef vref{.type = VertexType::GLYPH_3D, .index = i, .chunk = chunk_id};
-                if (m_vertex_to_selectable_map.count(vref))
-                    r.insert(m_vertex_to_selectable_map.at(vref));
+                if (auto sr = find_selectable_for_vertex_ref(vref))
+                    r.insert(*sr);
             }
         }
         for (size_t i = 0; i < chunk.m_face_groups.size(); i++) {
             if ((chunk.m_face_groups.at(i).flags & VertexFlags::SELECTED) != VertexFlags::DEFAULT) {
                 const VertexRef vref{.type = VertexType::FACE_GROUP, .index = i, .chunk = chunk_id};
-                if (m_vertex_to_selectable_map.count(vref))
-                    r.insert(m_vertex_to_selectable_map.at(vref));
+                if (auto sr = find_selectable_for_vertex_ref(vref))
+                    r.insert(*sr);
             }
         }
         for (size_t i = 0; i < chunk.m_icons.size(); i++) {
             if ((chunk.m_icons.at(i).flags & VertexFlags::SELECTED) != VertexFlags::DEFAULT) {
                 const VertexRef vref{.type = VertexType::ICON, .index = i, .chunk = chunk_id};
-                if (m_vertex_to_selectable_map.count(vref))
-                    r.insert(m_vertex_to_selectable_map.at(vref));
+                if (auto sr = find_selectable_for_vertex_ref(vref))
+                    r.insert(*sr);
             }
         }
         for (size_t i = 0; i < chunk.m_pictures.size(); i++) {
             if ((chunk.m_pictures.at(i).flags & VertexFlags::SELECTED) != VertexFlags::DEFAULT) {
                 const VertexRef vref{.type = VertexType::PICTURE, .index = i, .chunk = chunk_id};
-                if (m_vertex_to_selectable_map.count(vref))
-                    r.insert(m_vertex_to_selectable_map.at(vref));
+                if (auto sr = find_selectable_for_vertex_ref(vref))
+                    r.insert(*sr);
             }
         }
         chunk_id++;
@@ -1847,6 +2059,18 @@ void Canvas::update_bbox()
             acc_y.accumulate(fv.y);
             acc_z.accumulate(fv.z);
         }
+        for (const auto &group : chunk.m_face_groups) {
+            if (!group.shared_mesh || !group.length)
+                continue;
+            const auto &[a, b] = m_shared_face_meshes.at(group.shared_mesh).bbox;
+            for (unsigned int i = 0; i < 8; i++) {
+                const auto p = group.transform
+                               * glm::vec4((i & 1) ? b.x : a.x, (i & 2) ? b.y : a.y, (i & 4) ? b.z : a.z, 1);
+                acc_x.accumulate(p.x);
+                acc_y.accumulate(p.y);
+                acc_z.accumulate(p.z);
+            }
+        }
     }
     m_bbox.first = {acc_x.get_min(), acc_y.get_min(), acc_z.get_min()};
     m_bbox.second = {acc_x.get_max(), acc_y.get_max(), acc_z.get_max()};
@@ -44,6 +44,30 @@ public:
     Canvas();
 
     void request_push();
+    // bytes of vertex data uploaded for the last frame, only chunks that changed get uploaded
+    size_t get_upload_bytes() const
+    {
+        return m_upload_bytes;
+    }
+
+    // GPU memory taken up by faces as of the last push
+    struct FaceMemoryStats {
+        size_t n_triangles = 0;
+        size_t vertex_bytes = 0;
+        size_t index_bytes = 0;
+
+        double get_bytes_per_triangle() const
+        {
+            if (n_triangles == 0)
+                return 0;
+            return static_cast<double>(vertex_bytes + index_bytes) / n_triangles;
+        }
+    };
+    const FaceMemoryStats &get_face_memory_stats() const
+    {
+        return m_face_memory_stats;
+    }
+
     void queue_pick(const std::filesystem::path &pick_path);
 
     void clear() override;
@@ -51,10 +75,13 @@ public:
     VertexRef draw_point(glm::vec3 p) override;
     VertexRef draw_line(glm::vec3 from, glm::vec3 to) override;
     VertexRef draw_screen_line(glm::vec3 origin, glm::vec3 direction) override;
+    VertexRange draw_polylines(std::span<const glm::vec3> points, std::span<const size_t> path_sizes) override;
+    using ICanvas::draw_polyline;
     std::vector<VertexRef> draw_bitmap_text(glm::vec3 p, float size, const std::string &rtext) override;
     std::vector<VertexRef> draw_bitmap_text_3d(glm::vec3 p, const glm::quat &norm, float size,
                                                const std::string &rtext) override;
     void add_selectable(const VertexRef &vref, const SelectableRef &sref) override;
+    void add_selectable(const VertexRange &vrange, const SelectableRef &sref) override;
     void set_vertex_inactive(bool inactive) override
     {
         m_state.vertex_inactive = inactive;
@@ -81,6 +108,8 @@ public:
 
     VertexRef add_face_group(const face::Faces &faces, glm::vec3 origin, glm::quat normal,
                              FaceColor face_color) override;
+    VertexRef add_face_group_instance(std::shared_ptr<const face::Faces> faces, const glm::mat4 &transform,
+                                      FaceColor face_color) override;
 
     VertexRef draw_icon(IconTexture::IconTextureID id, glm::vec3 origin, glm::vec2 shift, glm::vec3 v) override;
     VertexRef draw_point(glm::vec3 point, IconTexture::IconTextureID id) override;
@@ -263,9 +292,31 @@ private:
 
     using pick_buf_t = uint32_t;
 
+    // rectangle of the pick buffer in device pixels, y going up as in glReadPixels
+    struct PickRegion {
+        int x = 0;
+        int y = 0;
+        int width = 0;
+        int height = 0;
+
+        bool contains(const PickRegion &other) const;
+        size_t get_size() const
+        {
+            return static_cast<size_t>(width) * height;
+        }
+    };
+
+    // part of the pick buffer read back from the GPU, picks outside of it read as 0
+    struct PickBuffer {
+        PickRegion region;
+        std::vector<pick_buf_t> data;
+
+        pick_buf_t get(int x, int y) const;
+    };
+
     void on_realize() override;
     bool on_render(const Glib::RefPtr<Gdk::GLContext> &context) override;
-    void render_all(std::vector<pick_buf_t> &pick_buf);
+    void render_all(const std::optional<PickRegion> &pick_region = {});
     void peel_selection();
     void on_resize(int width, int height) override;
     void resize_buffers();
@@ -286,8 +337,24 @@ private:
     std::filesystem::path m_pick_path;
 
 
-    std::vector<pick_buf_t> m_pick_buf;
-    pick_buf_t read_pick_buf(const std::vector<pick_buf_t> &pick_buf, int x, int y) const;
+    PickBuffer m_pick_buf;
+    pick_buf_t read_pick_buf(const PickBuffer &pick_buf, int x, int y) const;
+
+    // picks are read back through a pixel buffer object and copied out of it when
+    // needed, at the latest when the next frame starts, so reading them doesn't stall
+    GLuint m_pick_pbo;
+    size_t m_pick_pbo_size = 0;
+    std::optional<PickRegion> m_pick_pending;
+    PickRegion get_full_pick_region() const;
+    PickRegion get_hover_pick_region(int margin) const;
+    PickRegion get_pick_region_to_read() const;
+    void start_pick_readback(const PickRegion &region);
+    void finish_pick_readback();
+    void read_pick_buf_sync(PickBuffer &pick_buf, const PickRegion &region);
+    // makes m_pick_buf cover needed, for event handlers that can't wait for the next frame
+    void update_pick_buf(const PickRegion &needed, const PickRegion &to_read);
+    // set by selection peeling, as the pick attachment then doesn't hold the picks of the last frame
+    bool m_pick_fbo_peeled = false;
 
     GLuint m_renderbuffer;
     GLuint m_fbo;
@@ -312,6 +379,8 @@ private:
         PF_ALL = 0xff,
     };
     PushFlags m_push_flags = PF_ALL;
+    size_t m_upload_bytes = 0;
+    FaceMemoryStats m_face_memory_stats;
 
     int m_dev_width = 100;
     int m_dev_height = 100;
@@ -402,8 +471,32 @@ private:
 
     void add_faces(const face::Faces &faces);
 
-    std::map<VertexRef, SelectableRef> m_vertex_to_selectable_map;
-    std::map<SelectableRef, std::vector<VertexRef>> m_selectable_to_vertex_map;
+    class SharedFaceMesh {
+    public:
+        std::shared_ptr<const face::Faces> faces;
+        std::pair<glm::vec3, glm::vec3> bbox;
+        size_t n_vertices = 0;
+        size_t n_indices = 0;
+
+        // set by the face renderer once uploaded
+        bool uploaded = false;
+        // meshes with few enough vertices get 16 bit indices
+        bool short_indices = false;
+        size_t vertex_offset = 0;
+        size_t index_byte_offset = 0;
+
+        // 32 bit indices need to be aligned, so every mesh's indices take up a multiple of four bytes
+        size_t get_index_bytes() const
+        {
+            const size_t index_size = short_indices ? sizeof(uint16_t) : sizeof(uint32_t);
+            return (n_indices * index_size + 3) & ~size_t(3);
+        }
+    };
+    // keyed by the faces they were created from, entries not referenced by any chunk get dropped on push
+    std::map<const face::Faces *, SharedFaceMesh> m_shared_face_meshes;
+
+    const SelectableRef *find_selectable_for_vertex_ref(const VertexRef &vref) const;
+    void set_flags_for_selectable(const SelectableRef &sr, VertexFlags flags);
 
 
     VertexFlags &get_vertex_flags(const VertexRef &vref);
@@ -414,6 +507,16 @@ private:
     };
 
     std::map<std::pair<VertexType, unsigned int>, PickInfo> m_vertex_type_picks; // key vertex type, chunk
+
+    // m_vertex_type_picks sorted by offset for looking up picks
+    struct PickRange {
+        size_t offset;
+        size_t count;
+        VertexType type;
+        unsigned int chunk;
+    };
+    std::vector<PickRange> m_pick_ranges;
+    void update_pick_ranges();
     VertexRef get_vertex_ref_for_pick(unsigned int pick) const;
     std::optional<SelectableRef> get_selectable_ref_for_vertex_ref(const VertexRef &vref) const;
     std::optional<SelectableRef> get_selectable_ref_for_pick(unsigned int pick) const;
@@ -424,7 +527,10 @@ private:
     double m_last_x = 0, m_last_y = 0;
     void update_hover_selection();
     unsigned int get_hover_pick() const;
-    unsigned int get_hover_pick(const std::vector<pick_buf_t> &pick_buf) const;
+    unsigned int get_hover_pick(const PickBuffer &pick_buf) const;
+    static constexpr int s_hover_box_size = 10;
+    // hover reads cover this much more than the box, so that the cursor can move a bit until the next frame
+    static constexpr int s_hover_pick_margin = 32;
 
     type_signal_view_changed m_signal_view_changed;
     type_signal_view_changed m_signal_cursor_moved;
@@ -3,31 +3,40 @@
 
 namespace dune3d {
 
-void CanvasChunk::clear_flags(VertexFlags mask)
+template <typename T> static bool clear_flags_of(std::vector<T> &vertices, CanvasChunk::VertexFlags mask)
 {
-    for (auto &x : m_lines) {
-        x.flags &= ~mask;
-    }
-    for (auto &x : m_glyphs) {
-        x.flags &= ~mask;
-    }
-    for (auto &x : m_glyphs_3d) {
-        x.flags &= ~mask;
-    }
-    for (auto &x : m_face_groups) {
-        x.flags &= ~mask;
-    }
-    for (auto &x : m_icons) {
-        x.flags &= ~mask;
-    }
-    for (auto &x : m_pictures) {
-        x.flags &= ~mask;
+    bool changed = false;
+    for (auto &x : vertices) {
+        if ((x.flags & mask) != CanvasChunk::VertexFlags::DEFAULT) {
+            x.flags &= ~mask;
+            changed = true;
+        }
     }
+    return changed;
+}
+
+void CanvasChunk::clear_flags(VertexFlags mask)
+{
+    using VertexType = ICanvas::VertexType;
+    if (clear_flags_of(m_lines, mask))
+        set_dirty(VertexType::LINE);
+    if (clear_flags_of(m_glyphs, mask))
+        set_dirty(VertexType::GLYPH);
+    if (clear_flags_of(m_glyphs_3d, mask))
+        set_dirty(VertexType::GLYPH_3D);
+    // face groups and pictures pass their flags as uniforms, so there's nothing to upload
+    clear_flags_of(m_face_groups, mask);
+    if (clear_flags_of(m_icons, mask))
+        set_dirty(VertexType::ICON);
+    clear_flags_of(m_pictures, mask);
 }
 
 CanvasChunk::VertexFlags &CanvasChunk::get_vertex_flags(const ICanvas::VertexRef &vref)
 {
     using VertexType = ICanvas::VertexType;
+    // the caller most likely is going to modify them, see clear_flags for why faces and pictures aren't dirty
+    if (vref.type != VertexType::FACE_GROUP && vref.type != VertexType::PICTURE)
+        set_dirty(vref.type);
     switch (vref.type) {
     case VertexType::LINE:
         return m_lines.at(vref.index).flags;
@@ -64,6 +73,8 @@ void CanvasChunk::clear()
     m_icons.clear();
     m_icons_selection_invisible.clear();
     m_pictures.clear();
+    m_selectables.clear();
+    m_dirty = ~0u;
 }
 
 } // namespace dune3d
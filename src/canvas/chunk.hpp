@@ -4,7 +4,10 @@
 #include "icanvas.hpp"
 #include <glm/glm.hpp>
 #include "vertex_flags.hpp"
+#include "selectable_index.hpp"
 #include <array>
+#include <algorithm>
+#include <cmath>
 
 namespace dune3d {
 class CanvasChunk {
@@ -15,25 +18,50 @@ public:
     void clear();
     VertexFlags &get_vertex_flags(const ICanvas::VertexRef &vref);
 
+    // set if the vertices of that type changed without their number changing,
+    // renderers clear it once they uploaded them
+    void set_dirty(ICanvas::VertexType type)
+    {
+        m_dirty |= dirty_bit(type);
+    }
+    bool is_dirty(ICanvas::VertexType type) const
+    {
+        return m_dirty & dirty_bit(type);
+    }
+    void clear_dirty(ICanvas::VertexType type)
+    {
+        m_dirty &= ~dirty_bit(type);
+    }
+
 
     class FaceVertex {
     public:
         FaceVertex(float ix, float iy, float iz, float inx, float iny, float inz, uint8_t ir, uint8_t ig, uint8_t ib)
-            : x(ix), y(iy), z(iz), nx(inx), ny(iny), nz(inz), r(ir), g(ig), b(ib), _pad(0)
+            : x(ix), y(iy), z(iz), normal(pack_normal(inx, iny, inz)), r(ir), g(ig), b(ib), _pad(0)
         {
         }
         float x;
         float y;
         float z;
-        float nx;
-        float ny;
-        float nz;
+        // signed normalized 10:10:10:2 as in GL_INT_2_10_10_10_REV, w is unused
+        uint32_t normal;
 
         uint8_t r;
         uint8_t g;
         uint8_t b;
         uint8_t _pad;
+
+    private:
+        static uint32_t pack_component(float c)
+        {
+            return static_cast<uint32_t>(std::lround(std::clamp(c, -1.f, 1.f) * 511)) & 0x3ff;
+        }
+        static uint32_t pack_normal(float nx, float ny, float nz)
+        {
+            return pack_component(nx) | (pack_component(ny) << 10) | (pack_component(nz) << 20);
+        }
     } __attribute__((packed));
+    static_assert(sizeof(FaceVertex) == 20);
 
     std::vector<FaceVertex> m_face_vertex_buffer;  // vertices of all models, sequentially
     std::vector<unsigned int> m_face_index_buffer; // indexes face_vertex_buffer to form triangles
@@ -45,9 +73,10 @@ public:
     public:
         size_t offset;
         size_t length;
-        glm::vec3 origin;
-        glm::quat normal;
+        glm::mat4 transform;
         ICanvas::FaceColor color;
+        // if set, the faces are in the canvas' shared face meshes rather than in this chunk
+        const face::Faces *shared_mesh = nullptr;
 
         VertexFlags flags = VertexFlags::DEFAULT;
     };
@@ -145,5 +174,14 @@ public:
     };
 
     std::vector<Picture> m_pictures;
+
+    SelectableIndex m_selectables;
+
+private:
+    static uint32_t dirty_bit(ICanvas::VertexType type)
+    {
+        return 1u << static_cast<unsigned int>(type);
+    }
+    uint32_t m_dirty = ~0u;
 };
 } // namespace dune3d
@@ -0,0 +1,58 @@
+#include "chunked_buffer.hpp"
+
+namespace dune3d {
+
+size_t ChunkedBuffer::update(GLenum target, size_t element_size, std::span<const Slot> slots)
+{
+    bool relayout = slots.size() != m_regions.size();
+    for (size_t i = 0; i < slots.size() && !relayout; i++)
+        relayout = slots[i].size > m_regions.at(i).capacity;
+
+    size_t bytes = 0;
+    if (relayout) {
+        // leave half of each slot's size as room for growing, so that adding a few
+        // items to a chunk doesn't require uploading all of them again
+        m_regions.resize(slots.size());
+        m_capacity = 0;
+        for (size_t i = 0; i < slots.size(); i++) {
+            auto &region = m_regions.at(i);
+            region.offset = m_capacity;
+            region.capacity = slots[i].size + slots[i].size / 2;
+            m_capacity += region.capacity;
+        }
+        glBufferData(target, element_size * m_capacity, nullptr, GL_DYNAMIC_DRAW);
+    }
+
+    for (size_t i = 0; i < slots.size(); i++) {
+        const auto &slot = slots[i];
+        auto &region = m_regions.at(i);
+        if (!relayout && !slot.dirty && slot.size == region.size)
+            continue;
+        region.size = slot.size;
+        if (slot.size == 0)
+            continue;
+        glBufferSubData(target, element_size * region.offset, element_size * slot.size, slot.data);
+        bytes += element_size * slot.size;
+    }
+
+    return bytes;
+}
+
+void ChunkedBuffer::draw_arrays(GLenum mode, size_t first_slot, size_t n_slots) const
+{
+    std::vector<GLint> firsts;
+    std::vector<GLsizei> counts;
+    firsts.reserve(n_slots);
+    counts.reserve(n_slots);
+    for (size_t i = first_slot; i < first_slot + n_slots; i++) {
+        const auto &region = m_regions.at(i);
+        if (!region.size)
+            continue;
+        firsts.push_back(region.offset);
+        counts.push_back(region.size);
+    }
+    if (firsts.size())
+        glMultiDrawArrays(mode, firsts.data(), counts.data(), firsts.size());
+}
+
+} // namespace dune3d
@@ -0,0 +1,53 @@
+#pragma once
+#include <epoxy/gl.h>
+#include <vector>
+#include <span>
+
+namespace dune3d {
+
+// GL buffer holding one region per slot (usually a chunk), each with some room
+// to grow, so that only slots whose contents changed need to be uploaded again.
+class ChunkedBuffer {
+public:
+    class Slot {
+    public:
+        const void *data;
+        size_t size; // in elements
+        bool dirty;
+    };
+
+    class Region {
+    public:
+        size_t offset = 0;
+        size_t size = 0;
+        size_t capacity = 0;
+    };
+
+    // the buffer needs to be bound to target, returns the number of bytes uploaded
+    size_t update(GLenum target, size_t element_size, std::span<const Slot> slots);
+
+    const Region &get_region(size_t slot) const
+    {
+        return m_regions.at(slot);
+    }
+
+    size_t get_n_slots() const
+    {
+        return m_regions.size();
+    }
+
+    // in elements, including the room left for growing
+    size_t get_capacity() const
+    {
+        return m_capacity;
+    }
+
+    // draws the elements of n_slots slots starting at first_slot in one call
+    void draw_arrays(GLenum mode, size_t first_slot, size_t n_slots) const;
+
+private:
+    std::vector<Region> m_regions;
+    size_t m_capacity = 0;
+};
+
+} // namespace dune3d
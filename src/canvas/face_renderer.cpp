@@ -7,6 +7,7 @@
 #include <glm/gtc/type_ptr.hpp>
 #include <algorithm>
 #include <ranges>
+#include <set>
 #include "color_palette.hpp"
 
 namespace dune3d {
@@ -14,7 +15,7 @@ FaceRenderer::FaceRenderer(Canvas &c) : BaseRenderer(c, Canvas::VertexType::FACE
 {
 }
 
-void FaceRenderer::create_vao()
+void FaceRenderer::create_vao(GLuint &vao, GLuint &vbo, GLuint &ebo)
 {
     GLuint position_index = glGetAttribLocation(m_program, "position");
     GLuint normal_index = glGetAttribLocation(m_program, "normal");
@@ -22,15 +23,15 @@ void FaceRenderer::create_vao()
 
 
     /* we need to create a VAO to store the other buffers */
-    glGenVertexArrays(1, &m_vao);
-    glBindVertexArray(m_vao);
+    glGenVertexArrays(1, &vao);
+    glBindVertexArray(vao);
 
     /* this is the VBO that holds the vertex data */
-    glGenBuffers(1, &m_vbo);
-    glBindBuffer(GL_ARRAY_BUFFER, m_vbo);
+    glGenBuffers(1, &vbo);
+    glBindBuffer(GL_ARRAY_BUFFER, vbo);
 
-    glGenBuffers(1, &m_ebo);
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_ebo);
+    glGenBuffers(1, &ebo);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, ebo);
 
     std::vector<CanvasChunk::FaceVertex> vertices = {
             {-1, -1, 0, 0, 0, 1, 255, 0, 0}, {1, .1, 0, 0, 0, 1, 255, 0, 0}, {0, -.1, 0, 0, 0, 1, 255, 0, 0}};
@@ -44,8 +45,8 @@ void FaceRenderer::create_vao()
     glVertexAttribPointer(position_index, 3, GL_FLOAT, GL_FALSE, sizeof(CanvasChunk::FaceVertex),
                           (void *)offsetof(CanvasChunk::FaceVertex, x));
     glEnableVertexAttribArray(normal_index);
-    glVertexAttribPointer(normal_index, 3, GL_FLOAT, GL_FALSE, sizeof(CanvasChunk::FaceVertex),
-                          (void *)offsetof(CanvasChunk::FaceVertex, nx));
+    glVertexAttribPointer(normal_index, 4, GL_INT_2_10_10_10_REV, GL_TRUE, sizeof(CanvasChunk::FaceVertex),
+                          (void *)offsetof(CanvasChunk::FaceVertex, normal));
     glEnableVertexAttribArray(color_index);
     glVertexAttribPointer(color_index, 3, GL_UNSIGNED_BYTE, GL_TRUE, sizeof(CanvasChunk::FaceVertex),
                           (void *)offsetof(CanvasChunk::FaceVertex, r));
@@ -60,63 +61,189 @@ void FaceRenderer::realize()
 {
     m_program = gl_create_program_from_resource("/org/dune3d/dune3d/canvas/shaders/face-vertex.glsl",
                                                 "/org/dune3d/dune3d/canvas/shaders/face-fragment.glsl", nullptr);
-    create_vao();
+    create_vao(m_vao, m_vbo, m_ebo);
+    create_vao(m_shared_vao, m_shared_vbo, m_shared_ebo);
+    // everything needs to be uploaded again to the new buffers
+    m_vertex_buffer = ChunkedBuffer();
+    m_index_buffer = ChunkedBuffer();
+    m_shared_vertex_capacity = 0;
+    m_shared_index_bytes_capacity = 0;
 
     realize_base();
 
     GET_LOC(this, cam_normal);
     GET_LOC(this, flags);
-    GET_LOC(this, origin);
-    GET_LOC(this, normal_mat);
+    GET_LOC(this, model);
     GET_LOC(this, override_color);
     GET_LOC(this, clipping_value);
     GET_LOC(this, clipping_op);
 }
 
-void FaceRenderer::push()
+template <typename T>
+static void append_faces(std::vector<CanvasChunk::FaceVertex> &vertices, std::vector<T> &indices,
+                         const face::Faces &faces)
 {
-    size_t n_vertices = 0;
-    size_t n_idx = 0;
-    for (const auto &chunk : m_ca.m_chunks) {
-        n_vertices += chunk.m_face_vertex_buffer.size();
-        n_idx += chunk.m_face_index_buffer.size();
+    // indices are relative to the first vertex of the mesh, it's drawn with a base vertex
+    size_t vertex_offset = 0;
+    for (const auto &face : faces) {
+        for (size_t i = 0; i < face.vertices.size(); i++) {
+            const auto &v = face.vertices.at(i);
+            const auto &n = face.normals.at(i);
+            vertices.emplace_back(v.x, v.y, v.z, n.x, n.y, n.z, face.color.r * 255, face.color.g * 255,
+                                  face.color.b * 255);
+        }
+        for (const auto &[a, b, c] : face.triangle_indices) {
+            indices.push_back(a + vertex_offset);
+            indices.push_back(b + vertex_offset);
+            indices.push_back(c + vertex_offset);
+        }
+        vertex_offset += face.vertices.size();
     }
+}
 
-    const auto chunk_ids = m_ca.get_chunk_ids();
+void FaceRenderer::push_shared()
+{
+    auto &meshes = m_ca.m_shared_face_meshes;
+    std::set<const face::Faces *> used;
+    for (const auto &chunk : m_ca.m_chunks) {
+        for (const auto &group : chunk.m_face_groups) {
+            if (group.shared_mesh)
+                used.insert(group.shared_mesh);
+        }
+    }
 
-    {
-        size_t offset = 0;
-        glBindBuffer(GL_ARRAY_BUFFER, m_vbo);
-        glBufferData(GL_ARRAY_BUFFER, sizeof(CanvasChunk::FaceVertex) * n_vertices, nullptr, GL_STATIC_DRAW);
-
-        for (const auto chunk_id : chunk_ids) {
-            auto &chunk = m_ca.m_chunks.at(chunk_id);
-            chunk.m_face_offset = offset;
-            glBufferSubData(GL_ARRAY_BUFFER, offset * sizeof(CanvasChunk::FaceVertex),
-                            sizeof(CanvasChunk::FaceVertex) * chunk.m_face_vertex_buffer.size(),
-                            chunk.m_face_vertex_buffer.data());
-            offset += chunk.m_face_vertex_buffer.size();
+    size_t live_vertices = 0;
+    size_t live_index_bytes = 0;
+    size_t new_vertices = 0;
+    size_t new_index_bytes = 0;
+    for (auto it = meshes.begin(); it != meshes.end();) {
+        if (!used.contains(it->first)) {
+            it = meshes.erase(it);
+            continue;
+        }
+        const auto &mesh = it->second;
+        if (mesh.uploaded) {
+            live_vertices += mesh.n_vertices;
+            live_index_bytes += mesh.get_index_bytes();
         }
+        else {
+            new_vertices += mesh.n_vertices;
+            new_index_bytes += mesh.get_index_bytes();
+        }
+        it++;
+    }
+    if (new_vertices == 0 && new_index_bytes == 0)
+        return;
+
+    // new meshes get appended, everything is uploaded again if they don't fit
+    // or if more than half of the buffer is taken up by meshes that are gone
+    const bool fits = m_shared_vertices_used + new_vertices <= m_shared_vertex_capacity
+                      && m_shared_index_bytes_used + new_index_bytes <= m_shared_index_bytes_capacity;
+    const bool fragmented = m_shared_vertices_used > 2 * live_vertices;
+    const bool reallocate = !fits || fragmented;
+    if (reallocate) {
+        m_shared_vertex_capacity = 2 * (live_vertices + new_vertices);
+        m_shared_index_bytes_capacity = 2 * (live_index_bytes + new_index_bytes);
+        m_shared_vertices_used = 0;
+        m_shared_index_bytes_used = 0;
+    }
 
-        glBindBuffer(GL_ARRAY_BUFFER, 0);
+    // the element buffer binding is part of the VAO, so keep it bound to not clobber another one's
+    glBindVertexArray(m_shared_vao);
+    glBindBuffer(GL_ARRAY_BUFFER, m_shared_vbo);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_shared_ebo);
+    if (reallocate) {
+        glBufferData(GL_ARRAY_BUFFER, sizeof(CanvasChunk::FaceVertex) * m_shared_vertex_capacity, nullptr,
+                     GL_STATIC_DRAW);
+        glBufferData(GL_ELEMENT_ARRAY_BUFFER, m_shared_index_bytes_capacity, nullptr, GL_STATIC_DRAW);
+        for (auto &[key, mesh] : meshes)
+            mesh.uploaded = false;
     }
 
-    {
-        size_t offset = 0;
-        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_ebo);
-        glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(unsigned int) * n_idx, nullptr, GL_STATIC_DRAW);
-
-        for (const auto chunk_id : chunk_ids) {
-            auto &chunk = m_ca.m_chunks.at(chunk_id);
-            chunk.m_index_offset = offset;
-            glBufferSubData(GL_ELEMENT_ARRAY_BUFFER, offset * sizeof(unsigned int),
-                            sizeof(unsigned int) * chunk.m_face_index_buffer.size(), chunk.m_face_index_buffer.data());
-            offset += chunk.m_face_index_buffer.size();
+    std::vector<CanvasChunk::FaceVertex> vertices;
+    std::vector<uint16_t> indices_16;
+    std::vector<uint32_t> indices_32;
+    for (auto &[key, mesh] : meshes) {
+        if (mesh.uploaded)
+            continue;
+        vertices.clear();
+        const void *index_data;
+        size_t index_bytes;
+        if (mesh.short_indices) {
+            indices_16.clear();
+            append_faces(vertices, indices_16, *mesh.faces);
+            index_data = indices_16.data();
+            index_bytes = indices_16.size() * sizeof(uint16_t);
         }
+        else {
+            indices_32.clear();
+            append_faces(vertices, indices_32, *mesh.faces);
+            index_data = indices_32.data();
+            index_bytes = indices_32.size() * sizeof(uint32_t);
+        }
+        mesh.vertex_offset = m_shared_vertices_used;
+        mesh.index_byte_offset = m_shared_index_bytes_used;
+        glBufferSubData(GL_ARRAY_BUFFER, mesh.vertex_offset * sizeof(CanvasChunk::FaceVertex),
+                        sizeof(CanvasChunk::FaceVertex) * vertices.size(), vertices.data());
+        glBufferSubData(GL_ELEMENT_ARRAY_BUFFER, mesh.index_byte_offset, index_bytes, index_data);
+        m_ca.m_upload_bytes += sizeof(CanvasChunk::FaceVertex) * vertices.size() + index_bytes;
+        m_shared_vertices_used += vertices.size();
+        m_shared_index_bytes_used += mesh.get_index_bytes();
+        mesh.uploaded = true;
+    }
+    glBindVertexArray(0);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
 
-        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+void FaceRenderer::update_memory_stats()
+{
+    auto &stats = m_ca.m_face_memory_stats;
+    stats = {};
+    for (const auto &chunk : m_ca.m_chunks) {
+        stats.n_triangles += chunk.m_face_index_buffer.size() / 3;
+        stats.vertex_bytes += chunk.m_face_vertex_buffer.size() * sizeof(CanvasChunk::FaceVertex);
+        stats.index_bytes += chunk.m_face_index_buffer.size() * sizeof(unsigned int);
+    }
+    // shared meshes take up memory once, no matter how often they're drawn
+    for (const auto &[key, mesh] : m_ca.m_shared_face_meshes) {
+        stats.n_triangles += mesh.n_indices / 3;
+        stats.vertex_bytes += mesh.n_vertices * sizeof(CanvasChunk::FaceVertex);
+        stats.index_bytes += mesh.get_index_bytes();
+    }
+}
+
+void FaceRenderer::push()
+{
+    push_shared();
+
+    const auto chunk_ids = m_ca.get_chunk_ids();
+    std::vector<ChunkedBuffer::Slot> vertex_slots;
+    std::vector<ChunkedBuffer::Slot> index_slots;
+    vertex_slots.reserve(chunk_ids.size());
+    index_slots.reserve(chunk_ids.size());
+    for (const auto chunk_id : chunk_ids) {
+        const auto &chunk = m_ca.m_chunks.at(chunk_id);
+        const bool dirty = chunk.is_dirty(m_vertex_type);
+        vertex_slots.push_back({chunk.m_face_vertex_buffer.data(), chunk.m_face_vertex_buffer.size(), dirty});
+        index_slots.push_back({chunk.m_face_index_buffer.data(), chunk.m_face_index_buffer.size(), dirty});
     }
 
+    glBindBuffer(GL_ARRAY_BUFFER, m_vbo);
+    m_ca.m_upload_bytes += m_vertex_buffer.update(GL_ARRAY_BUFFER, sizeof(CanvasChunk::FaceVertex), vertex_slots);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_ebo);
+    m_ca.m_upload_bytes += m_index_buffer.update(GL_ELEMENT_ARRAY_BUFFER, sizeof(unsigned int), index_slots);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+
+    for (size_t i = 0; i < chunk_ids.size(); i++) {
+        auto &chunk = m_ca.m_chunks.at(chunk_ids.at(i));
+        chunk.m_face_offset = m_vertex_buffer.get_region(i).offset;
+        chunk.m_index_offset = m_index_buffer.get_region(i).offset;
+        chunk.clear_dirty(m_vertex_type);
+    }
+    update_memory_stats();
+
     m_type_pick_base = m_ca.m_pick_base;
     for (const auto chunk_id : chunk_ids) {
         const auto &chunk = m_ca.m_chunks.at(chunk_id);
@@ -161,14 +288,20 @@ void FaceRenderer::render()
     glUniform3fv(m_cam_normal_loc, 1, glm::value_ptr(m_ca.m_cam_normal));
 
     size_t group_idx = 0;
+    bool shared_vao_bound = false;
     const auto chunk_ids = m_ca.get_chunk_ids();
     for (const auto chunk_id : chunk_ids) {
         const auto &chunk = m_ca.m_chunks.at(chunk_id);
 
         for (const auto &group : chunk.m_face_groups) {
+            const bool shared = group.shared_mesh;
+            if (shared != shared_vao_bound) {
+                glBindVertexArray(shared ? m_shared_vao : m_vao);
+                shared_vao_bound = shared;
+            }
             glUniform1ui(m_pick_base_loc, m_type_pick_base + group_idx);
             glUniform1ui(m_flags_loc, static_cast<uint32_t>(group.flags));
-            glUniform3fv(m_origin_loc, 1, glm::value_ptr(group.origin));
+            glUniformMatrix4fv(m_model_loc, 1, GL_FALSE, glm::value_ptr(group.transform));
             if (group.color == ICanvas::FaceColor::AS_IS) {
                 glUniform3f(m_override_color_loc, NAN, NAN, NAN);
             }
@@ -178,12 +311,17 @@ void FaceRenderer::render()
                 const auto color = m_ca.m_appearance.get_color(colorp);
                 gl_color_to_uniform_3f(m_override_color_loc, color);
             }
-            glm::mat3 normal_mat = glm::transpose(glm::toMat3(group.normal));
-
-            glUniformMatrix3fv(m_normal_mat_loc, 1, GL_FALSE, glm::value_ptr(normal_mat));
-            glDrawElementsBaseVertex(GL_TRIANGLES, group.length, GL_UNSIGNED_INT,
-                                     (void *)((group.offset + chunk.m_index_offset) * sizeof(unsigned int)),
-                                     chunk.m_face_offset);
+            if (shared) {
+                const auto &mesh = m_ca.m_shared_face_meshes.at(group.shared_mesh);
+                glDrawElementsBaseVertex(GL_TRIANGLES, group.length,
+                                         mesh.short_indices ? GL_UNSIGNED_SHORT : GL_UNSIGNED_INT,
+                                         (void *)mesh.index_byte_offset, mesh.vertex_offset);
+            }
+            else {
+                glDrawElementsBaseVertex(GL_TRIANGLES, group.length, GL_UNSIGNED_INT,
+                                         (void *)((group.offset + chunk.m_index_offset) * sizeof(unsigned int)),
+                                         chunk.m_face_offset);
+            }
             group_idx++;
         }
     }
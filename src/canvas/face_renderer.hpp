@@ -1,5 +1,6 @@
 #pragma once
 #include "base_renderer.hpp"
+#include "chunked_buffer.hpp"
 
 namespace dune3d {
 class FaceRenderer : public BaseRenderer {
@@ -10,16 +11,29 @@ public:
     void push();
 
 private:
-    void create_vao();
+    void create_vao(GLuint &vao, GLuint &vbo, GLuint &ebo);
+    void push_shared();
+    void update_memory_stats();
 
     GLuint m_vao;
     GLuint m_vbo;
     GLuint m_ebo;
+    ChunkedBuffer m_vertex_buffer;
+    ChunkedBuffer m_index_buffer;
+
+    // shared face meshes, these are only uploaded when they're new
+    GLuint m_shared_vao;
+    GLuint m_shared_vbo;
+    GLuint m_shared_ebo;
+    // indices are 16 or 32 bit depending on the mesh, so their space is counted in bytes
+    size_t m_shared_vertex_capacity = 0;
+    size_t m_shared_index_bytes_capacity = 0;
+    size_t m_shared_vertices_used = 0;
+    size_t m_shared_index_bytes_used = 0;
 
     GLuint m_cam_normal_loc;
     GLuint m_flags_loc;
-    GLuint m_origin_loc;
-    GLuint m_normal_mat_loc;
+    GLuint m_model_loc;
     GLuint m_override_color_loc;
 
     GLuint m_clipping_value_loc;
@@ -85,6 +85,8 @@ void Glyph3DRenderer::realize()
                                                 "/org/dune3d/dune3d/canvas/shaders/glyph-fragment.glsl",
                                                 "/org/dune3d/dune3d/canvas/shaders/glyph-3d-geometry.glsl");
     m_vao = create_vao(m_program, m_vbo);
+    // everything needs to be uploaded again to the new buffer
+    m_buffer = ChunkedBuffer();
 
     realize_base();
 
@@ -99,21 +101,27 @@ void Glyph3DRenderer::push()
         m_ca.m_n_glyphs_3d += chunk.m_glyphs_3d.size();
     }
 
+    const auto chunk_ids = m_ca.get_chunk_ids();
+    std::vector<ChunkedBuffer::Slot> slots;
+    slots.reserve(chunk_ids.size());
+    for (const auto chunk_id : chunk_ids) {
+        const auto &chunk = m_ca.m_chunks.at(chunk_id);
+        slots.push_back({chunk.m_glyphs_3d.data(), chunk.m_glyphs_3d.size(), chunk.is_dirty(m_vertex_type)});
+    }
+
     glBindBuffer(GL_ARRAY_BUFFER, m_vbo);
-    glBufferData(GL_ARRAY_BUFFER, sizeof(CanvasChunk::Glyph3DVertex) * m_ca.m_n_glyphs_3d, nullptr, GL_STATIC_DRAW);
+    m_ca.m_upload_bytes += m_buffer.update(GL_ARRAY_BUFFER, sizeof(CanvasChunk::Glyph3DVertex), slots);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
 
-    auto chunk_ids = m_ca.get_chunk_ids();
-    size_t offset = 0;
     m_type_pick_base = m_ca.m_pick_base;
-    for (const auto chunk_id : chunk_ids) {
+    for (size_t i = 0; i < chunk_ids.size(); i++) {
+        const auto chunk_id = chunk_ids.at(i);
         auto &chunk = m_ca.m_chunks.at(chunk_id);
-        glBufferSubData(GL_ARRAY_BUFFER, sizeof(CanvasChunk::Glyph3DVertex) * offset,
-                        sizeof(CanvasChunk::Glyph3DVertex) * chunk.m_glyphs_3d.size(), chunk.m_glyphs_3d.data());
-        m_ca.m_vertex_type_picks[{m_vertex_type, chunk_id}] = {.offset = m_ca.m_pick_base,
-                                                               .count = chunk.m_glyphs_3d.size()};
-        m_ca.m_pick_base += chunk.m_glyphs_3d.size();
-        offset += chunk.m_glyphs_3d.size();
+        m_ca.m_vertex_type_picks[{m_vertex_type, chunk_id}] = {
+                .offset = m_type_pick_base + m_buffer.get_region(i).offset, .count = chunk.m_glyphs_3d.size()};
+        chunk.clear_dirty(m_vertex_type);
     }
+    m_ca.m_pick_base += m_buffer.get_capacity();
 }
 
 void Glyph3DRenderer::render()
@@ -130,7 +138,7 @@ void Glyph3DRenderer::render()
     glUniformMatrix3fv(m_screen_loc, 1, GL_FALSE, glm::value_ptr(m_ca.m_screenmat));
     load_uniforms();
 
-    glDrawArrays(GL_POINTS, 0, m_ca.m_n_glyphs_3d);
+    m_buffer.draw_arrays(GL_POINTS, 0, m_buffer.get_n_slots());
 }
 
 } // namespace dune3d
@@ -84,6 +84,8 @@ void GlyphRenderer::realize()
                                                 "/org/dune3d/dune3d/canvas/shaders/glyph-fragment.glsl",
                                                 "/org/dune3d/dune3d/canvas/shaders/glyph-geometry.glsl");
     m_vao = create_vao(m_program, m_vbo);
+    // everything needs to be uploaded again to the new buffer
+    m_buffer = ChunkedBuffer();
 
     realize_base();
 
@@ -99,21 +101,27 @@ void GlyphRenderer::push()
         m_ca.m_n_glyphs += chunk.m_glyphs.size();
     }
 
+    const auto chunk_ids = m_ca.get_chunk_ids();
+    std::vector<ChunkedBuffer::Slot> slots;
+    slots.reserve(chunk_ids.size());
+    for (const auto chunk_id : chunk_ids) {
+        const auto &chunk = m_ca.m_chunks.at(chunk_id);
+        slots.push_back({chunk.m_glyphs.data(), chunk.m_glyphs.size(), chunk.is_dirty(m_vertex_type)});
+    }
+
     glBindBuffer(GL_ARRAY_BUFFER, m_vbo);
-    glBufferData(GL_ARRAY_BUFFER, sizeof(CanvasChunk::GlyphVertex) * m_ca.m_n_glyphs, nullptr, GL_STATIC_DRAW);
+    m_ca.m_upload_bytes += m_buffer.update(GL_ARRAY_BUFFER, sizeof(CanvasChunk::GlyphVertex), slots);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
 
-    auto chunk_ids = m_ca.get_chunk_ids();
-    size_t offset = 0;
     m_type_pick_base = m_ca.m_pick_base;
-    for (const auto chunk_id : chunk_ids) {
+    for (size_t i = 0; i < chunk_ids.size(); i++) {
+        const auto chunk_id = chunk_ids.at(i);
         auto &chunk = m_ca.m_chunks.at(chunk_id);
-        glBufferSubData(GL_ARRAY_BUFFER, sizeof(CanvasChunk::GlyphVertex) * offset,
-                        sizeof(CanvasChunk::GlyphVertex) * chunk.m_glyphs.size(), chunk.m_glyphs.data());
-        m_ca.m_vertex_type_picks[{m_vertex_type, chunk_id}] = {.offset = m_ca.m_pick_base,
-                                                               .count = chunk.m_glyphs.size()};
-        m_ca.m_pick_base += chunk.m_glyphs.size();
-        offset += chunk.m_glyphs.size();
+        m_ca.m_vertex_type_picks[{m_vertex_type, chunk_id}] = {
+                .offset = m_type_pick_base + m_buffer.get_region(i).offset, .count = chunk.m_glyphs.size()};
+        chunk.clear_dirty(m_vertex_type);
     }
+    m_ca.m_pick_base += m_buffer.get_capacity();
 }
 
 void GlyphRenderer::render()
@@ -131,7 +139,7 @@ void GlyphRenderer::render()
     glUniformMatrix3fv(m_screen_loc, 1, GL_FALSE, glm::value_ptr(m_ca.m_screenmat));
     load_uniforms();
 
-    glDrawArrays(GL_POINTS, 0, m_ca.m_n_glyphs);
+    m_buffer.draw_arrays(GL_POINTS, 0, m_buffer.get_n_slots());
 }
 
 
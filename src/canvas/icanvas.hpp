@@ -4,6 +4,7 @@
 #include "face.hpp"
 #include <glm/gtx/quaternion.hpp>
 #include <memory>
+#include <span>
 
 namespace dune3d {
 
@@ -26,6 +27,14 @@ public:
         friend bool operator==(const VertexRef &, const VertexRef &) = default;
     };
 
+    // consecutive vertices of the same type, for selecting many of them at once
+    struct VertexRange {
+        VertexType type;
+        size_t first;
+        size_t count;
+        unsigned int chunk;
+    };
+
     enum class LineStyle {
         DEFAULT = 0,
         THIN = (1 << 0),
@@ -37,6 +46,13 @@ public:
     virtual VertexRef draw_point(glm::vec3 p) = 0;
     virtual VertexRef draw_line(glm::vec3 from, glm::vec3 to) = 0;
     virtual VertexRef draw_screen_line(glm::vec3 origin, glm::vec3 direction) = 0;
+    // lines through the points of each path, path_sizes being the number of points in each of them
+    virtual VertexRange draw_polylines(std::span<const glm::vec3> points, std::span<const size_t> path_sizes) = 0;
+    VertexRange draw_polyline(std::span<const glm::vec3> points)
+    {
+        const size_t n = points.size();
+        return draw_polylines(points, {&n, 1});
+    }
     virtual std::vector<VertexRef> draw_bitmap_text(glm::vec3 p, float size, const std::string &rtext) = 0;
     virtual std::vector<VertexRef> draw_bitmap_text_3d(glm::vec3 p, const glm::quat &norm, float size,
                                                        const std::string &rtext) = 0;
@@ -45,6 +61,10 @@ public:
     enum class FaceColor { AS_IS, SOLID_MODEL, OTHER_BODY_SOLID_MODEL };
     virtual VertexRef add_face_group(const face::Faces &faces, glm::vec3 origin, glm::quat normal,
                                      FaceColor face_color) = 0;
+    // for meshes that get drawn more than once, such as STEP models: they're uploaded
+    // once and drawn with the given transform, faces are kept around as long as they're used
+    virtual VertexRef add_face_group_instance(std::shared_ptr<const face::Faces> faces, const glm::mat4 &transform,
+                                              FaceColor face_color) = 0;
     virtual VertexRef draw_icon(IconTexture::IconTextureID id, glm::vec3 origin, glm::vec2 shift,
                                 glm::vec3 v = {NAN, NAN, NAN}) = 0;
     virtual VertexRef draw_point(glm::vec3 origin, IconTexture::IconTextureID id) = 0;
@@ -52,6 +72,7 @@ public:
                                    std::shared_ptr<const PictureData> data) = 0;
 
     virtual void add_selectable(const VertexRef &vref, const SelectableRef &sref) = 0;
+    virtual void add_selectable(const VertexRange &vrange, const SelectableRef &sref) = 0;
     virtual void set_selection_invisible(bool selection_invisible) = 0;
 
     virtual void save() = 0;
@@ -116,6 +116,8 @@ void IconRenderer::realize()
                                                 "/org/dune3d/dune3d/canvas/shaders/icon-fragment.glsl",
                                                 "/org/dune3d/dune3d/canvas/shaders/icon-geometry.glsl");
     m_vao = create_vao(m_program, m_vbo);
+    // everything needs to be uploaded again to the new buffer
+    m_buffer = ChunkedBuffer();
     m_ca.m_n_icons = 1;
 
     realize_base();
@@ -137,35 +139,34 @@ void IconRenderer::push()
         m_ca.m_n_icons_selection_invisible += chunk.m_icons_selection_invisible.size();
     }
 
-    glBindBuffer(GL_ARRAY_BUFFER, m_vbo);
-    glBufferData(GL_ARRAY_BUFFER,
-                 sizeof(CanvasChunk::IconVertex) * (m_ca.m_n_icons + m_ca.m_n_icons_selection_invisible), nullptr,
-                 GL_STATIC_DRAW);
-
     // first buffer selection-visible vertices of all groups, then selection-invisble ones
 
-    auto chunk_ids = m_ca.get_chunk_ids();
-    size_t offset = 0;
-
-    m_type_pick_base = m_ca.m_pick_base;
+    const auto chunk_ids = m_ca.get_chunk_ids();
+    std::vector<ChunkedBuffer::Slot> slots;
+    slots.reserve(chunk_ids.size() * 2);
     for (const auto chunk_id : chunk_ids) {
-        auto &chunk = m_ca.m_chunks.at(chunk_id);
-        glBufferSubData(GL_ARRAY_BUFFER, sizeof(CanvasChunk::IconVertex) * offset,
-                        sizeof(CanvasChunk::IconVertex) * chunk.m_icons.size(), chunk.m_icons.data());
-
-        m_ca.m_vertex_type_picks[{m_vertex_type, chunk_id}] = {.offset = m_ca.m_pick_base,
-                                                               .count = chunk.m_icons.size()};
-        m_ca.m_pick_base += chunk.m_icons.size();
-        offset += chunk.m_icons.size();
+        const auto &chunk = m_ca.m_chunks.at(chunk_id);
+        slots.push_back({chunk.m_icons.data(), chunk.m_icons.size(), chunk.is_dirty(m_vertex_type)});
     }
     for (const auto chunk_id : chunk_ids) {
-        auto &chunk = m_ca.m_chunks.at(chunk_id);
-        glBufferSubData(GL_ARRAY_BUFFER, sizeof(CanvasChunk::IconVertex) * offset,
-                        sizeof(CanvasChunk::IconVertex) * chunk.m_icons_selection_invisible.size(),
-                        chunk.m_icons_selection_invisible.data());
+        const auto &chunk = m_ca.m_chunks.at(chunk_id);
+        slots.push_back({chunk.m_icons_selection_invisible.data(), chunk.m_icons_selection_invisible.size(),
+                         chunk.is_dirty(m_vertex_type)});
+    }
+
+    glBindBuffer(GL_ARRAY_BUFFER, m_vbo);
+    m_ca.m_upload_bytes += m_buffer.update(GL_ARRAY_BUFFER, sizeof(CanvasChunk::IconVertex), slots);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
 
-        offset += chunk.m_icons_selection_invisible.size();
+    m_type_pick_base = m_ca.m_pick_base;
+    for (size_t i = 0; i < chunk_ids.size(); i++) {
+        const auto chunk_id = chunk_ids.at(i);
+        auto &chunk = m_ca.m_chunks.at(chunk_id);
+        m_ca.m_vertex_type_picks[{m_vertex_type, chunk_id}] = {
+                .offset = m_type_pick_base + m_buffer.get_region(i).offset, .count = chunk.m_icons.size()};
+        chunk.clear_dirty(m_vertex_type);
     }
+    m_ca.m_pick_base += m_buffer.get_capacity();
 }
 
 void IconRenderer::render()
@@ -186,9 +187,11 @@ void IconRenderer::render()
     glUniformMatrix3fv(m_screen_loc, 1, GL_FALSE, glm::value_ptr(m_ca.m_screenmat));
     load_uniforms();
 
-    glDrawArrays(GL_POINTS, 0, m_ca.m_n_icons);
+    // one slot per chunk for selection-visible vertices, then one for selection-invisible ones
+    const auto n_chunks = m_buffer.get_n_slots() / 2;
+    m_buffer.draw_arrays(GL_POINTS, 0, n_chunks);
     glColorMaski(1, GL_FALSE, GL_FALSE, GL_FALSE, GL_FALSE);
-    glDrawArrays(GL_POINTS, m_ca.m_n_icons, m_ca.m_n_icons_selection_invisible);
+    m_buffer.draw_arrays(GL_POINTS, n_chunks, n_chunks);
     glColorMask(GL_TRUE, GL_TRUE, GL_TRUE, GL_TRUE);
 }
 
@@ -1,5 +1,6 @@
 #pragma once
 #include "base_renderer.hpp"
+#include "chunked_buffer.hpp"
 
 namespace dune3d {
 class IconRenderer : public BaseRenderer {
@@ -12,6 +13,7 @@ public:
 private:
     GLuint m_vao;
     GLuint m_vbo;
+    ChunkedBuffer m_buffer;
 
     GLuint m_screen_loc;
     GLuint m_tex_loc;
@@ -62,6 +62,8 @@ void LineRenderer::realize()
                                                 "/org/dune3d/dune3d/canvas/shaders/line-fragment.glsl",
                                                 "/org/dune3d/dune3d/canvas/shaders/line-geometry.glsl");
     m_vao = create_vao(m_program, m_vbo);
+    // everything needs to be uploaded again to the new buffer
+    m_buffer = ChunkedBuffer();
 
     realize_base();
     GET_LOC(this, screen_scale);
@@ -78,35 +80,35 @@ void LineRenderer::push()
         m_ca.m_n_lines_selection_invisible += chunk.m_lines_selection_invisible.size();
     }
 
-    glBindBuffer(GL_ARRAY_BUFFER, m_vbo);
-    glBufferData(GL_ARRAY_BUFFER,
-                 sizeof(CanvasChunk::LineVertex) * (m_ca.m_n_lines + m_ca.m_n_lines_selection_invisible), nullptr,
-                 GL_STATIC_DRAW);
-
     // first buffer selection-visible vertices of all chunks, then selection-invisble ones
 
-    auto chunk_ids = m_ca.get_chunk_ids();
-    size_t offset = 0;
-
-    m_type_pick_base = m_ca.m_pick_base;
+    const auto chunk_ids = m_ca.get_chunk_ids();
+    std::vector<ChunkedBuffer::Slot> slots;
+    slots.reserve(chunk_ids.size() * 2);
     for (const auto chunk_id : chunk_ids) {
-        auto &chunk = m_ca.m_chunks.at(chunk_id);
-        glBufferSubData(GL_ARRAY_BUFFER, sizeof(CanvasChunk::LineVertex) * offset,
-                        sizeof(CanvasChunk::LineVertex) * chunk.m_lines.size(), chunk.m_lines.data());
-
-        m_ca.m_vertex_type_picks[{m_vertex_type, chunk_id}] = {.offset = m_ca.m_pick_base,
-                                                               .count = chunk.m_lines.size()};
-        m_ca.m_pick_base += chunk.m_lines.size();
-        offset += chunk.m_lines.size();
+        const auto &chunk = m_ca.m_chunks.at(chunk_id);
+        slots.push_back({chunk.m_lines.data(), chunk.m_lines.size(), chunk.is_dirty(m_vertex_type)});
     }
     for (const auto chunk_id : chunk_ids) {
-        auto &chunk = m_ca.m_chunks.at(chunk_id);
-        glBufferSubData(GL_ARRAY_BUFFER, sizeof(CanvasChunk::LineVertex) * offset,
-                        sizeof(CanvasChunk::LineVertex) * chunk.m_lines_selection_invisible.size(),
-                        chunk.m_lines_selection_invisible.data());
+        const auto &chunk = m_ca.m_chunks.at(chunk_id);
+        slots.push_back({chunk.m_lines_selection_invisible.data(), chunk.m_lines_selection_invisible.size(),
+                         chunk.is_dirty(m_vertex_type)});
+    }
+
+    glBindBuffer(GL_ARRAY_BUFFER, m_vbo);
+    m_ca.m_upload_bytes += m_buffer.update(GL_ARRAY_BUFFER, sizeof(CanvasChunk::LineVertex), slots);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
 
-        offset += chunk.m_lines_selection_invisible.size();
+    // picks are offset by where the vertices ended up in the buffer
+    m_type_pick_base = m_ca.m_pick_base;
+    for (size_t i = 0; i < chunk_ids.size(); i++) {
+        const auto chunk_id = chunk_ids.at(i);
+        auto &chunk = m_ca.m_chunks.at(chunk_id);
+        m_ca.m_vertex_type_picks[{m_vertex_type, chunk_id}] = {
+                .offset = m_type_pick_base + m_buffer.get_region(i).offset, .count = chunk.m_lines.size()};
+        chunk.clear_dirty(m_vertex_type);
     }
+    m_ca.m_pick_base += m_buffer.get_capacity();
 }
 
 void LineRenderer::render()
@@ -125,9 +127,11 @@ void LineRenderer::render()
 
     glUniform1f(m_line_width_loc, m_ca.m_appearance.line_width * m_ca.m_scale_factor);
 
-    glDrawArrays(GL_POINTS, 0, m_ca.m_n_lines);
+    // one slot per chunk for selection-visible vertices, then one for selection-invisible ones
+    const auto n_chunks = m_buffer.get_n_slots() / 2;
+    m_buffer.draw_arrays(GL_POINTS, 0, n_chunks);
     glColorMaski(1, GL_FALSE, GL_FALSE, GL_FALSE, GL_FALSE);
-    glDrawArrays(GL_POINTS, m_ca.m_n_lines, m_ca.m_n_lines_selection_invisible);
+    m_buffer.draw_arrays(GL_POINTS, n_chunks, n_chunks);
     glColorMask(GL_TRUE, GL_TRUE, GL_TRUE, GL_TRUE);
 }
 
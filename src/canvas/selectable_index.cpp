@@ -0,0 +1,112 @@
+#include "selectable_index.hpp"
+#include <algorithm>
+#include <functional>
+
+namespace dune3d {
+
+static size_t hash_selectable(const SelectableRef &sr)
+{
+    size_t h = sr.item.hash();
+    h ^= std::hash<unsigned int>{}(sr.point) + 0x9e3779b97f4a7c15ull + (h << 6) + (h >> 2);
+    h ^= static_cast<size_t>(sr.type) + 0x9e3779b97f4a7c15ull + (h << 6) + (h >> 2);
+    return h;
+}
+
+uint32_t SelectableIndex::find_id(const SelectableRef &sr) const
+{
+    if (m_table.empty())
+        return s_none;
+    const size_t mask = m_table.size() - 1;
+    for (size_t slot = hash_selectable(sr) & mask;; slot = (slot + 1) & mask) {
+        const auto id = m_table[slot];
+        if (id == s_none || m_selectables[id - 1] == sr)
+            return id;
+    }
+}
+
+void SelectableIndex::grow_table()
+{
+    // table size is a power of two and kept at most half full, so probing always terminates
+    std::vector<uint32_t> table(std::max<size_t>(64, m_table.size() * 2), s_none);
+    const size_t mask = table.size() - 1;
+    for (uint32_t id = 1; id <= m_selectables.size(); id++) {
+        size_t slot = hash_selectable(m_selectables[id - 1]) & mask;
+        while (table[slot] != s_none)
+            slot = (slot + 1) & mask;
+        table[slot] = id;
+    }
+    m_table = std::move(table);
+}
+
+uint32_t SelectableIndex::get_or_create_id(const SelectableRef &sr)
+{
+    if (auto id = find_id(sr))
+        return id;
+
+    if ((m_selectables.size() + 1) * 2 > m_table.size())
+        grow_table();
+
+    m_selectables.push_back(sr);
+    m_ranges.emplace_back();
+    const uint32_t id = m_selectables.size();
+    const size_t mask = m_table.size() - 1;
+    size_t slot = hash_selectable(sr) & mask;
+    while (m_table[slot] != s_none)
+        slot = (slot + 1) & mask;
+    m_table[slot] = id;
+    return id;
+}
+
+void SelectableIndex::add(VertexType type, size_t first, size_t count, const SelectableRef &sr)
+{
+    if (count == 0)
+        return;
+    const auto id = get_or_create_id(sr);
+
+    auto &ids = m_vertex_ids.at(static_cast<size_t>(type));
+    if (ids.size() < first + count)
+        ids.resize(first + count, s_none);
+    for (size_t i = first; i < first + count; i++) {
+        // first one wins, as with a map
+        if (ids[i] == s_none)
+            ids[i] = id;
+    }
+
+    auto &ranges = m_ranges.at(id - 1);
+    if (ranges.size()) {
+        auto &last = ranges.back();
+        if (last.type == type && last.first + last.count == first) {
+            last.count += count;
+            return;
+        }
+    }
+    ranges.push_back({type, first, count});
+}
+
+const SelectableRef *SelectableIndex::find(VertexType type, size_t index) const
+{
+    if (type == VertexType::SELECTION_INVISIBLE)
+        return nullptr;
+    const auto &ids = m_vertex_ids.at(static_cast<size_t>(type));
+    if (index >= ids.size() || ids[index] == s_none)
+        return nullptr;
+    return &m_selectables[ids[index] - 1];
+}
+
+const std::vector<SelectableIndex::Range> *SelectableIndex::find_ranges(const SelectableRef &sr) const
+{
+    if (auto id = find_id(sr))
+        return &m_ranges[id - 1];
+    return nullptr;
+}
+
+void SelectableIndex::clear()
+{
+    m_selectables.clear();
+    m_ranges.clear();
+    std::fill(m_table.begin(), m_table.end(), s_none);
+    for (auto &ids : m_vertex_ids)
+        ids.clear();
+}
+
+} // namespace dune3d
@@ -0,0 +1,46 @@
+#pragma once
+#include "icanvas.hpp"
+#include "selectable_ref.hpp"
+#include <array>
+#include <cstdint>
+#include <vector>
+
+namespace dune3d {
+
+// Maps a chunk's vertices to selectables and back. Vertices are looked up
+// through a vector per vertex type, selectables through an open addressing
+// hash table, so neither direction needs any tree lookups.
+class SelectableIndex {
+public:
+    using VertexType = ICanvas::VertexType;
+
+    void add(VertexType type, size_t first, size_t count, const SelectableRef &sr);
+    const SelectableRef *find(VertexType type, size_t index) const;
+
+    class Range {
+    public:
+        VertexType type;
+        size_t first;
+        size_t count;
+    };
+    // ranges of vertices mapping to sr, adjacent vertices end up in the same range
+    const std::vector<Range> *find_ranges(const SelectableRef &sr) const;
+
+    void clear();
+
+private:
+    static constexpr uint32_t s_none = 0;
+    static constexpr size_t s_n_vertex_types = static_cast<size_t>(VertexType::SELECTION_INVISIBLE);
+
+    // ids are indices into m_selectables plus one, so that zero can mean empty
+    uint32_t find_id(const SelectableRef &sr) const;
+    uint32_t get_or_create_id(const SelectableRef &sr);
+    void grow_table();
+
+    std::vector<SelectableRef> m_selectables;
+    std::vector<std::vector<Range>> m_ranges;
+    std::vector<uint32_t> m_table;
+    std::array<std::vector<uint32_t>, s_n_vertex_types> m_vertex_ids;
+};
+
+} // namespace dune3d
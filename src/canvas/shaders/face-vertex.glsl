@@ -11,8 +11,7 @@ flat out float select_alpha_to_frag;
 
 uniform mat4 view;
 uniform mat4 proj;
-uniform vec3 origin;
-uniform mat3 normal_mat;
+uniform mat4 model;
 uniform vec3 override_color;
 uniform uint flags;
 
@@ -24,8 +23,8 @@ void main()
     color_to_fragment = color;
     if(override_color.r == override_color.r && !isnan(override_color.r))  // isnan() is broken on some platforms, but nan == nan evaluates to true on some others
         color_to_fragment = override_color;
-    vec4 p4 = vec4(position*normal_mat + origin, 1);
-    vec4 n4 = vec4(normal, 0);
+    vec4 p4 = model * vec4(position, 1);
+    vec4 n4 = model * vec4(normal, 0);
 
     gl_Position = (proj * view) * p4;
     pos_to_fragment = p4.xyz;
@@ -4,6 +4,7 @@
 #include "nlohmann/json.hpp"
 #include "tool_id.hpp"
 #include "document/document.hpp"
+#include "document/document_snapshot.hpp"
 #include "document/group/group.hpp"
 #include "document/group/group_extrude.hpp"
 #include "document/entity/entity_workplane.hpp"
@@ -20,6 +21,10 @@ namespace dune3d {
 
 Core::Core(EditorInterface &intf) : m_intf(intf), m_constraint_preview_tool(ToolID::NONE)
 {
+    m_rebuild_scheduler.set_handler(
+            [this](const UUID &doc_uu, std::unique_ptr<Document> doc, uint64_t revision) {
+                handle_rebuild_done(doc_uu, std::move(doc), revision);
+            });
 }
 
 Core::~Core() = default;
@@ -66,6 +71,7 @@ void Core::close_document(const UUID &uu)
 {
     if (!m_documents.at(uu).m_can_close)
         return;
+    m_rebuild_scheduler.cancel(uu);
     m_documents.erase(uu);
     if (m_current_document == uu && m_documents.size()) {
         m_current_document = m_documents.begin()->first;
@@ -108,6 +114,7 @@ void Core::undo()
     if (get_current_document_info().undo()) {
         fix_current_group();
         update_can_close();
+        schedule_rebuild(get_current_document_info());
         m_signal_rebuilt.emit();
         m_signal_needs_save.emit();
     }
@@ -120,6 +127,7 @@ void Core::redo()
     if (get_current_document_info().redo()) {
         fix_current_group();
         update_can_close();
+        schedule_rebuild(get_current_document_info());
         m_signal_rebuilt.emit();
         m_signal_needs_save.emit();
     }
@@ -166,41 +174,65 @@ Core::DocumentInfo::DocumentInfo(const UUID &uu, const std::filesystem::path &pa
 
 class HistoryItemDocument : public HistoryManager::HistoryItem {
 public:
-    HistoryItemDocument(const Document &doc, const std::string &cm) : HistoryManager::HistoryItem(cm), document(doc)
+    HistoryItemDocument(Document &doc, const HistoryItemDocument *previous, const std::string &cm)
+        : HistoryManager::HistoryItem(cm), snapshot(doc, previous ? &previous->snapshot : nullptr)
     {
     }
-    Document document;
+    DocumentSnapshot snapshot;
 };
 
+const HistoryItemDocument *Core::DocumentInfo::get_current_history_item() const
+{
+    if (!m_history_manager.has_current())
+        return nullptr;
+    return &dynamic_cast<const HistoryItemDocument &>(m_history_manager.get_current());
+}
+
 const Document &Core::DocumentInfo::get_last_document() const
 {
-    return dynamic_cast<const HistoryItemDocument &>(m_history_manager.get_current()).document;
+    // snapshots only share their items, so build the document on demand
+    if (!m_last_document)
+        m_last_document.emplace(get_current_history_item()->snapshot);
+    return m_last_document.value();
 }
 
 void Core::DocumentInfo::history_push(const std::string &comment)
 {
-    m_history_manager.push(std::make_unique<HistoryItemDocument>(m_doc.value(), comment));
+    auto it = std::make_unique<HistoryItemDocument>(m_doc.value(), get_current_history_item(), comment);
+    m_last_document.reset();
+    m_history_manager.push(std::move(it));
 }
 
-void Core::DocumentInfo::history_load(const HistoryManager::HistoryItem &it)
+void Core::DocumentInfo::history_replace_current()
+{
+    const auto &comment = m_history_manager.get_current().comment;
+    auto it = std::make_unique<HistoryItemDocument>(m_doc.value(), get_current_history_item(), comment);
+    m_last_document.reset();
+    m_history_manager.replace_current(std::move(it));
+}
+
+void Core::DocumentInfo::history_load(const HistoryManager::HistoryItem &it, const HistoryItemDocument *current)
 {
     auto &itd = dynamic_cast<const HistoryItemDocument &>(it);
-    m_doc.reset();
-    m_doc.emplace(itd.document);
+    m_last_document.reset();
+    // keeps the items that are the same in both history items
+    m_doc->load_snapshot(itd.snapshot, current ? &current->snapshot : nullptr);
     m_needs_save = true;
 }
 
 void Core::DocumentInfo::revert()
 {
-    m_doc.reset();
-    m_doc.emplace(get_last_document());
+    // only copies the items changed since the history item was taken
+    auto current = get_current_history_item();
+    m_doc->load_snapshot(current->snapshot, &current->snapshot);
 }
 
 bool Core::DocumentInfo::undo()
 {
     if (!m_history_manager.can_undo())
         return false;
-    history_load(m_history_manager.undo());
+    auto current = get_current_history_item();
+    history_load(m_history_manager.undo(), current);
 
     return true;
 }
@@ -209,7 +241,8 @@ bool Core::DocumentInfo::redo()
 {
     if (!m_history_manager.can_redo())
         return false;
-    history_load(m_history_manager.redo());
+    auto current = get_current_history_item();
+    history_load(m_history_manager.redo(), current);
 
     return true;
 }
@@ -397,6 +430,8 @@ ToolResponse Core::tool_begin(ToolID tool_id, const ToolArgs &args, bool transie
         throw std::runtime_error("can't begin tool while tool is active");
         return ToolResponse::end();
     }
+    // tools expect a solved document and rebuilds that finish while the tool is active get dropped
+    finish_rebuild();
     ToolStateSetter state_setter{m_tool_state, ToolState::BEGINNING};
     if (state_setter.check_error())
         return ToolResponse::end();
@@ -440,6 +475,7 @@ ToolResponse Core::tool_begin(ToolID tool_id, const ToolArgs &args, bool transie
         return ToolResponse::end();
     }
     if (m_tool) {
+        get_current_document().clear_solver_cache();
         m_current_groups_sorted = get_current_document().get_groups_sorted();
         m_signal_tool_changed.emit();
         ToolResponse r;
@@ -530,6 +566,7 @@ bool Core::is_read_only() const
 void Core::save_all()
 {
     for (auto &[uu, doc] : m_documents) {
+        finish_rebuild(doc);
         doc.save();
     }
     m_signal_needs_save.emit();
@@ -539,6 +576,8 @@ void Core::save()
 {
     if (!has_documents())
         return;
+    // don't save parameters that haven't been solved yet
+    finish_rebuild(get_current_document_info());
     get_current_document_info().save();
     m_signal_needs_save.emit();
 }
@@ -547,6 +586,7 @@ void Core::save_as(const std::filesystem::path &path)
 {
     if (!has_documents())
         return;
+    finish_rebuild(get_current_document_info());
     get_current_document_info().save_as(path);
     m_signal_needs_save.emit();
 }
@@ -563,6 +603,7 @@ bool Core::maybe_end_tool(const ToolResponse &r)
         const auto current_group = r.get_current_group();
         std::cout << "end tool" << std::endl;
         m_tool.reset();
+        get_current_document().clear_solver_cache();
         m_signal_tool_changed.emit();
         if (r.result == ToolResponse::Result::COMMIT) {
             if (current_group)
@@ -577,7 +618,8 @@ bool Core::maybe_end_tool(const ToolResponse &r)
             rebuild_internal(true, "undo");
         }
         else if (r.result == ToolResponse::Result::END) { // did nothing
-            // do nothing
+            // a background rebuild might have been dropped while the tool was active
+            schedule_rebuild(get_current_document_info());
         }
         // tool_id_current = ToolID::NONE;
         return true;
@@ -634,12 +676,104 @@ void Core::rebuild_internal(bool from_undo, const std::string &comment)
     if (!has_documents())
         return;
     fix_current_group();
-    for (auto &[uu, en] : get_current_document().m_entities) {
-        en->m_selection_invisible = false;
+    auto &doc = get_current_document();
+    for (auto &[uu, en] : doc.m_entities) {
+        if (en->m_selection_invisible) {
+            en->m_selection_invisible = false;
+            doc.set_item_changed(uu);
+        }
     }
-    get_current_document().update_pending();
     update_can_close();
     rebuild_finish(from_undo, comment);
+    schedule_rebuild(get_current_document_info());
+}
+
+void Core::schedule_rebuild(DocumentInfo &doci)
+{
+    if (!doci.get_document().has_pending()) {
+        if (m_rebuild_scheduler.is_busy(doci.get_uuid())) {
+            m_rebuild_scheduler.cancel(doci.get_uuid());
+            m_signal_rebuild_state_changed.emit();
+        }
+        return;
+    }
+    m_rebuild_scheduler.schedule(doci.get_uuid(), doci.get_document());
+    m_signal_rebuild_state_changed.emit();
+}
+
+void Core::cancel_rebuild()
+{
+    if (!has_documents())
+        return;
+    if (!m_rebuild_scheduler.is_busy(m_current_document))
+        return;
+    m_rebuild_scheduler.cancel(m_current_document);
+    m_signal_rebuild_state_changed.emit();
+}
+
+bool Core::is_rebuilding(const UUID &doc_uu) const
+{
+    return m_rebuild_scheduler.is_busy(doc_uu);
+}
+
+void Core::update_step_solid_models()
+{
+    for (auto &[uu, doci] : m_documents) {
+        if (!doci.get_document().set_step_solid_models_pending())
+            continue;
+        // the tool updates the document by itself, ending it schedules a rebuild
+        if (uu == m_current_document && (m_tool || m_constraint_preview_tool != ToolID::NONE))
+            continue;
+        schedule_rebuild(doci);
+    }
+}
+
+void Core::handle_rebuild_done(const UUID &doc_uu, std::unique_ptr<Document> doc, uint64_t revision)
+{
+    if (!m_documents.contains(doc_uu))
+        return;
+    if (doc_uu == m_current_document && (m_tool || m_constraint_preview_tool != ToolID::NONE)) {
+        // only happens for rebuilds that were already done before the tool started, since
+        // starting the tool finished the rebuild, ending the tool schedules another one
+        m_signal_rebuild_state_changed.emit();
+        return;
+    }
+    auto &doci = m_documents.at(doc_uu);
+    if (doci.get_document().get_revision() != revision) {
+        // edited without scheduling a rebuild since the copy was made, the result doesn't apply anymore
+        schedule_rebuild(doci);
+        return;
+    }
+    doci.get_document().take_update_results(std::move(*doc));
+    // the history item got pushed before rebuilding
+    doci.history_replace_current();
+    if (doc_uu == m_current_document) {
+        fix_current_group();
+        update_can_close();
+    }
+    m_signal_rebuilt.emit();
+    m_signal_rebuild_state_changed.emit();
+    // STEP imports that got ready while rebuilding were missed by update_step_solid_models
+    if (doci.get_document().set_step_solid_models_pending())
+        schedule_rebuild(doci);
+}
+
+void Core::finish_rebuild(DocumentInfo &doci)
+{
+    if (!doci.get_document().has_pending())
+        return;
+    m_rebuild_scheduler.cancel(doci.get_uuid());
+    doci.get_document().update_pending();
+    doci.history_replace_current();
+    m_signal_rebuilt.emit();
+    m_signal_rebuild_state_changed.emit();
+}
+
+void Core::finish_rebuild()
+{
+    if (!has_documents())
+        return;
+    finish_rebuild(get_current_document_info());
 }
 
 void Core::rebuild(const std::string &comment)
@@ -674,6 +808,7 @@ bool Core::apply_preview(ToolID tool_id, const std::set<SelectableRef> &sel)
 
     if (m_constraint_preview_tool != ToolID::NONE)
         reset_preview();
+    finish_rebuild();
 
     auto tool = create_tool(tool_id, ToolBase::Flags::PREVIEW);
     tool->m_selection = sel;
@@ -702,6 +837,7 @@ bool Core::reset_preview()
         return false;
     get_current_document_info().revert();
     m_constraint_preview_tool = ToolID::NONE;
+    schedule_rebuild(get_current_document_info());
     return true;
 }
 
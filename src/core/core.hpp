@@ -8,10 +8,12 @@
 #include "tool.hpp"
 #include "idocument_info.hpp"
 #include "idocument_provider.hpp"
+#include "rebuild_scheduler.hpp"
 
 namespace dune3d {
 
 class EditorInterface;
+class HistoryItemDocument;
 
 class Core : public ICore, public IDocumentProvider {
 public:
@@ -46,6 +48,12 @@ public:
         return m_signal_rebuilt;
     }
 
+    using type_signal_rebuild_state_changed = sigc::signal<void()>;
+    type_signal_rebuild_state_changed signal_rebuild_state_changed()
+    {
+        return m_signal_rebuild_state_changed;
+    }
+
     using type_signal_needs_save = sigc::signal<void()>;
     type_signal_needs_save signal_needs_save()
     {
@@ -90,6 +98,18 @@ public:
     void save_as(const std::filesystem::path &path);
 
     void rebuild(const std::string &comment);
+    // Commits, undo and redo rebuild the document in the background, so until
+    // that's done, the current document may have groups that aren't generated
+    // or solved yet. Rendering, hit testing and the workspace browser work on
+    // that and get updated once the rebuild is done. Starting a tool or a
+    // constraint preview finishes the rebuild first, exports and actions that
+    // read the document's geometry need to call this before.
+    void finish_rebuild();
+    void cancel_rebuild();
+    bool is_rebuilding(const UUID &doc_uu) const;
+    // rebuilds solid models that got built before the STEP imports in them were
+    // ready, to be called whenever an import finished
+    void update_step_solid_models();
 
     void undo();
     void redo();
@@ -168,8 +188,9 @@ private:
         bool undo();
         bool redo();
 
-        void history_load(const HistoryManager::HistoryItem &it);
+        void history_load(const HistoryManager::HistoryItem &it, const HistoryItemDocument *current);
         void history_push(const std::string &comment);
+        void history_replace_current();
         void revert();
         void save();
         void save_as(const std::filesystem::path &path);
@@ -225,6 +246,10 @@ private:
         bool m_from_entity = false;
         bool m_can_close = true;
         HistoryManager m_history_manager;
+
+    private:
+        const HistoryItemDocument *get_current_history_item() const;
+        mutable std::optional<Document> m_last_document;
     };
 
     DocumentInfo &get_current_document_info()
@@ -245,6 +270,12 @@ private:
     type_signal_tool_changed m_signal_tool_changed;
     type_signal_rebuilt m_signal_rebuilt;
     type_signal_needs_save m_signal_needs_save;
+    type_signal_rebuild_state_changed m_signal_rebuild_state_changed;
+
+    RebuildScheduler m_rebuild_scheduler;
+    void schedule_rebuild(DocumentInfo &doci);
+    void handle_rebuild_done(const UUID &doc_uu, std::unique_ptr<Document> doc, uint64_t revision);
+    void finish_rebuild(DocumentInfo &doci);
 
     void rebuild_internal(bool from_undo, const std::string &comment);
     void rebuild_finish(bool from_undo, const std::string &comment);
@@ -0,0 +1,116 @@
+#include "rebuild_scheduler.hpp"
+#include "document/document.hpp"
+#include "logger/logger.hpp"
+#include "logger/log_util.hpp"
+
+namespace dune3d {
+
+RebuildScheduler::RebuildScheduler()
+{
+    m_dispatcher.connect([this] {
+        std::list<Job> results;
+        {
+            std::lock_guard<std::mutex> guard(m_mutex);
+            results.splice(results.begin(), m_results);
+        }
+        for (auto &job : results) {
+            {
+                std::lock_guard<std::mutex> guard(m_mutex);
+                // a newer edit arrived while we were rebuilding, throw the result away
+                if (!m_current_generations.contains(job.doc_uu)
+                    || m_current_generations.at(job.doc_uu) != job.generation)
+                    continue;
+                m_current_generations.erase(job.doc_uu);
+            }
+            if (m_handler)
+                m_handler(job.doc_uu, std::move(job.doc), job.revision);
+        }
+    });
+    m_thread = std::thread(&RebuildScheduler::worker, this);
+}
+
+void RebuildScheduler::set_handler(result_handler_t h)
+{
+    m_handler = h;
+}
+
+void RebuildScheduler::schedule(const UUID &doc_uu, const Document &doc)
+{
+    auto snapshot = std::make_unique<Document>(doc);
+    {
+        std::lock_guard<std::mutex> guard(m_mutex);
+        const auto generation = ++m_generation;
+        m_current_generations[doc_uu] = generation;
+        m_pending_jobs.insert_or_assign(doc_uu, Job{doc_uu, generation, doc.get_revision(), std::move(snapshot)});
+    }
+    m_cond.notify_one();
+}
+
+void RebuildScheduler::cancel(const UUID &doc_uu)
+{
+    std::lock_guard<std::mutex> guard(m_mutex);
+    m_current_generations.erase(doc_uu);
+    m_pending_jobs.erase(doc_uu);
+}
+
+bool RebuildScheduler::is_busy(const UUID &doc_uu) const
+{
+    std::lock_guard<std::mutex> guard(m_mutex);
+    return m_current_generations.contains(doc_uu);
+}
+
+bool RebuildScheduler::is_current(const UUID &doc_uu, unsigned int generation) const
+{
+    std::lock_guard<std::mutex> guard(m_mutex);
+    if (m_stop)
+        return false;
+    auto it = m_current_generations.find(doc_uu);
+    return it != m_current_generations.end() && it->second == generation;
+}
+
+void RebuildScheduler::worker()
+{
+    while (true) {
+        Job job;
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_cond.wait(lock, [this] { return m_stop || m_pending_jobs.size(); });
+            if (m_stop)
+                return;
+            auto it = m_pending_jobs.begin();
+            job = std::move(it->second);
+            m_pending_jobs.erase(it);
+        }
+
+        try {
+            const auto doc_uu = job.doc_uu;
+            const auto generation = job.generation;
+            job.doc->update_pending({}, {}, [this, doc_uu, generation] { return !is_current(doc_uu, generation); });
+        }
+        CATCH_LOG(Logger::Level::CRITICAL, "error rebuilding document", Logger::Domain::CORE)
+
+        if (!is_current(job.doc_uu, job.generation))
+            continue;
+
+        {
+            std::lock_guard<std::mutex> guard(m_mutex);
+            m_results.push_back(std::move(job));
+        }
+        m_dispatcher.emit();
+    }
+}
+
+RebuildScheduler::~RebuildScheduler()
+{
+    {
+        // also cancels the rebuild in progress, so that we don't have to wait for it
+        std::lock_guard<std::mutex> guard(m_mutex);
+        m_stop = true;
+        m_current_generations.clear();
+        m_pending_jobs.clear();
+    }
+    m_cond.notify_one();
+    m_thread.join();
+}
+
+} // namespace dune3d
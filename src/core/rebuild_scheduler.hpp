@@ -0,0 +1,61 @@
+#pragma once
+#include <glibmm/dispatcher.h>
+#include "util/uuid.hpp"
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <list>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+namespace dune3d {
+
+class Document;
+
+// Runs Document::update_pending on a snapshot of a document in a worker thread
+// and hands the rebuilt document back to the main thread. Only the most recently
+// scheduled rebuild of each document is ever delivered, older ones get cancelled
+// or discarded.
+class RebuildScheduler {
+public:
+    RebuildScheduler();
+
+    void schedule(const UUID &doc_uu, const Document &doc);
+    void cancel(const UUID &doc_uu);
+    bool is_busy(const UUID &doc_uu) const;
+
+    // revision is the one of the document the rebuilt copy was made from
+    using result_handler_t =
+            std::function<void(const UUID &doc_uu, std::unique_ptr<Document> doc, uint64_t revision)>;
+    void set_handler(result_handler_t h);
+
+    ~RebuildScheduler();
+
+private:
+    struct Job {
+        UUID doc_uu;
+        unsigned int generation;
+        uint64_t revision;
+        std::unique_ptr<Document> doc;
+    };
+
+    void worker();
+    bool is_current(const UUID &doc_uu, unsigned int generation) const;
+
+    Glib::Dispatcher m_dispatcher;
+    result_handler_t m_handler;
+
+    mutable std::mutex m_mutex;
+    std::condition_variable m_cond;
+    bool m_stop = false;
+    unsigned int m_generation = 0;
+    std::map<UUID, unsigned int> m_current_generations;
+    std::map<UUID, Job> m_pending_jobs;
+    std::list<Job> m_results;
+
+    std::thread m_thread;
+};
+
+} // namespace dune3d
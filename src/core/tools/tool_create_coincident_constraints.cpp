@@ -61,7 +61,7 @@ void ToolCreateCoincidentConstraints::reset()
 {
     auto &doc = get_doc();
     for (const auto &uu : m_constraints) {
-        doc.m_constraints.erase(uu);
+        doc.erase_constraint(uu);
     }
     m_constraints.clear();
 
@@ -225,7 +225,7 @@ Constraint *ToolDrawContour::constrain_point_and_add_head_tangent_constraint(con
                 if (!redundant_before) {
                     const auto redundant_after = current_group_has_redundant_constraints();
                     if (redundant_after) {
-                        get_doc().m_constraints.erase(new_constraint->m_uuid);
+                        get_doc().erase_constraint(new_constraint->m_uuid);
                         new_constraint = nullptr;
                     }
                 }
@@ -557,7 +557,7 @@ ToolResponse ToolDrawContour::update(const ToolArgs &args)
                 if (!redundant_before) {
                     const auto redundant_after = current_group_has_redundant_constraints();
                     if (redundant_after) {
-                        get_doc().m_constraints.erase(constraint->m_uuid);
+                        get_doc().erase_constraint(constraint->m_uuid);
                         constraint = nullptr;
                     }
                 }
@@ -713,15 +713,13 @@ ToolResponse ToolDrawContour::update(const ToolArgs &args)
                     update_arc_center();
                     m_temp_arc->m_wrkpl = m_wrkpl->m_uuid;
                     m_temp_arc->m_selection_invisible = true;
-                    for (auto constraint : m_constraints) {
-                        for (unsigned int pt = 1; pt <= 2; pt++) {
-                            unsigned int arc_pt = pt;
-                            if (m_flip_arc)
-                                arc_pt = 3 - pt;
-                            constraint->replace_point({m_temp_line->m_uuid, pt}, {m_temp_arc->m_uuid, arc_pt});
-                        }
+                    for (unsigned int pt = 1; pt <= 2; pt++) {
+                        unsigned int arc_pt = pt;
+                        if (m_flip_arc)
+                            arc_pt = 3 - pt;
+                        replace_point({m_temp_line->m_uuid, pt}, {m_temp_arc->m_uuid, arc_pt});
                     }
-                    get_doc().m_entities.erase(m_temp_line->m_uuid);
+                    get_doc().erase_entity(m_temp_line->m_uuid);
                     m_temp_line = nullptr;
                     m_entities.back() = m_temp_arc;
                 }
@@ -732,15 +730,13 @@ ToolResponse ToolDrawContour::update(const ToolArgs &args)
                     m_temp_line->m_p2 = m_temp_arc->get_point_in_workplane(get_arc_head_point());
                     m_temp_line->m_wrkpl = m_wrkpl->m_uuid;
                     m_temp_line->m_selection_invisible = true;
-                    for (auto constraint : m_constraints) {
-                        for (unsigned int pt = 1; pt <= 2; pt++) {
-                            unsigned int arc_pt = pt;
-                            if (m_flip_arc)
-                                arc_pt = 3 - pt;
-                            constraint->replace_point({m_temp_arc->m_uuid, arc_pt}, {m_temp_line->m_uuid, pt});
-                        }
+                    for (unsigned int pt = 1; pt <= 2; pt++) {
+                        unsigned int arc_pt = pt;
+                        if (m_flip_arc)
+                            arc_pt = 3 - pt;
+                        replace_point({m_temp_arc->m_uuid, arc_pt}, {m_temp_line->m_uuid, pt});
                     }
-                    get_doc().m_entities.erase(m_temp_arc->m_uuid);
+                    get_doc().erase_entity(m_temp_arc->m_uuid);
                     m_temp_arc = nullptr;
                     m_entities.back() = m_temp_line;
                 }
@@ -758,12 +754,10 @@ ToolResponse ToolDrawContour::update(const ToolArgs &args)
                     m_temp_bezier->m_c2 = m_temp_bezier->m_p2;
                     m_temp_bezier->m_wrkpl = m_wrkpl->m_uuid;
                     m_temp_bezier->m_selection_invisible = true;
-                    for (auto constraint : m_constraints) {
-                        for (unsigned int pt = 1; pt <= 2; pt++) {
-                            constraint->replace_point({m_temp_line->m_uuid, pt}, {m_temp_bezier->m_uuid, pt});
-                        }
+                    for (unsigned int pt = 1; pt <= 2; pt++) {
+                        replace_point({m_temp_line->m_uuid, pt}, {m_temp_bezier->m_uuid, pt});
                     }
-                    get_doc().m_entities.erase(m_temp_line->m_uuid);
+                    get_doc().erase_entity(m_temp_line->m_uuid);
                     m_temp_line = nullptr;
                     m_entities.back() = m_temp_bezier;
                 }
@@ -774,12 +768,10 @@ ToolResponse ToolDrawContour::update(const ToolArgs &args)
                     m_temp_line->m_p2 = m_temp_bezier->m_p2;
                     m_temp_line->m_wrkpl = m_wrkpl->m_uuid;
                     m_temp_line->m_selection_invisible = true;
-                    for (auto constraint : m_constraints) {
-                        for (unsigned int pt = 1; pt <= 2; pt++) {
-                            constraint->replace_point({m_temp_bezier->m_uuid, pt}, {m_temp_line->m_uuid, pt});
-                        }
+                    for (unsigned int pt = 1; pt <= 2; pt++) {
+                        replace_point({m_temp_bezier->m_uuid, pt}, {m_temp_line->m_uuid, pt});
                     }
-                    get_doc().m_entities.erase(m_temp_bezier->m_uuid);
+                    get_doc().erase_entity(m_temp_bezier->m_uuid);
                     m_temp_bezier = nullptr;
                     m_entities.back() = m_temp_line;
                 }
@@ -819,14 +811,19 @@ void ToolDrawContour::set_flip_arc(bool flip)
         return;
 
     std::swap(m_temp_arc->m_from, m_temp_arc->m_to);
-    for (auto constraint : m_constraints) {
-        constraint->replace_point({m_temp_arc->m_uuid, 1}, {m_temp_arc->m_uuid, 10});
-        constraint->replace_point({m_temp_arc->m_uuid, 2}, {m_temp_arc->m_uuid, 1});
-        constraint->replace_point({m_temp_arc->m_uuid, 10}, {m_temp_arc->m_uuid, 2});
-    }
+    replace_point({m_temp_arc->m_uuid, 1}, {m_temp_arc->m_uuid, 10});
+    replace_point({m_temp_arc->m_uuid, 2}, {m_temp_arc->m_uuid, 1});
+    replace_point({m_temp_arc->m_uuid, 10}, {m_temp_arc->m_uuid, 2});
     m_flip_arc = flip;
 }
 
+void ToolDrawContour::replace_point(const EntityAndPoint &old_point, const EntityAndPoint &new_point)
+{
+    // through the document, since rewiring constraints changes what the solver sees
+    for (auto constraint : m_constraints)
+        get_doc().get_constraint(constraint->m_uuid).replace_point(old_point, new_point);
+}
+
 unsigned int ToolDrawContour::get_last_point() const
 {
     unsigned int last_point = 2;
@@ -841,9 +838,9 @@ ToolResponse ToolDrawContour::end_tool()
         for (auto constraint : m_constraints) {
             auto ents = constraint->get_referenced_entities();
             if (ents.contains(t->m_uuid))
-                get_doc().m_constraints.erase(constraint->m_uuid);
+                get_doc().erase_constraint(constraint->m_uuid);
         }
-        get_doc().m_entities.erase(t->m_uuid);
+        get_doc().erase_entity(t->m_uuid);
         return ToolResponse::commit();
     }
     else {
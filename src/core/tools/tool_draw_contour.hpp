@@ -64,6 +64,7 @@ private:
     glm::dvec2 m_last;
     bool m_flip_arc = false;
     void set_flip_arc(bool flip);
+    void replace_point(const EntityAndPoint &old_point, const EntityAndPoint &new_point);
     unsigned int get_arc_tail_point() const;
     unsigned int get_arc_head_point() const;
     unsigned int get_head_point() const;
@@ -64,10 +64,10 @@ void ToolDrawLine3D::update_tip()
 ToolResponse ToolDrawLine3D::end_tool()
 {
     if (m_temp_line) {
-        m_core.get_current_document().m_entities.erase(m_temp_line->m_uuid);
+        m_core.get_current_document().erase_entity(m_temp_line->m_uuid);
         m_temp_line = nullptr;
         if (m_constraint)
-            m_core.get_current_document().m_constraints.erase(m_constraint->m_uuid);
+            m_core.get_current_document().erase_constraint(m_constraint->m_uuid);
         return ToolResponse::commit();
     }
     else {
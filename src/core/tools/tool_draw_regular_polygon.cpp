@@ -38,7 +38,7 @@ glm::dvec2 ToolDrawRegularPolygon::get_cursor_pos_in_plane() const
 void ToolDrawRegularPolygon::set_n_sides(unsigned int n)
 {
     for (auto it : m_sides) {
-        get_doc().m_entities.erase(it->m_uuid);
+        get_doc().erase_entity(it->m_uuid);
     }
     m_sides.clear();
     for (unsigned int i = 0; i < n; i++) {
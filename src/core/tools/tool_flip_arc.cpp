@@ -25,9 +25,12 @@ ToolResponse ToolFlipArc::begin(const ToolArgs &args)
     std::swap(arc.m_from, arc.m_to);
 
     for (auto &[uu, constraint] : get_doc().m_constraints) {
-        constraint->replace_point({arc.m_uuid, 1}, {arc.m_uuid, 11});
-        constraint->replace_point({arc.m_uuid, 2}, {arc.m_uuid, 1});
-        constraint->replace_point({arc.m_uuid, 11}, {arc.m_uuid, 2});
+        if (!constraint->get_referenced_entities().contains(arc.m_uuid))
+            continue;
+        auto &co = get_doc().get_constraint(uu);
+        co.replace_point({arc.m_uuid, 1}, {arc.m_uuid, 11});
+        co.replace_point({arc.m_uuid, 2}, {arc.m_uuid, 1});
+        co.replace_point({arc.m_uuid, 11}, {arc.m_uuid, 2});
     }
 
     return ToolResponse::commit();
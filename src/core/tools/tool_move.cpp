@@ -11,6 +11,7 @@
 #include "document/constraint/constraint_angle.hpp"
 #include "editor/editor_interface.hpp"
 #include "tool_common_impl.hpp"
+#include <utility>
 
 namespace dune3d {
 
@@ -63,7 +64,9 @@ ToolResponse ToolMove::begin(const ToolArgs &args)
                             sr.item, m_intf.get_cursor_pos_for_plane(constraint->get_origin(get_doc()), vecs.n));
                 }
             }
-            get_doc().accumulate_first_group(first_group_render, get_doc().get_constraint(sr.item).m_group);
+            auto &constraint = get_doc().get_constraint(sr.item);
+            get_doc().accumulate_first_group(first_group_render, constraint.m_group);
+            m_constraints.push_back(&constraint);
         }
         // we don't care about constraints since dragging them is pureley cosmetic
     }
@@ -90,12 +93,15 @@ ToolResponse ToolMove::update(const ToolArgs &args)
     auto &last_doc = m_core.get_current_last_document();
     if (args.type == ToolEventType::MOVE) {
         const auto delta = m_intf.get_cursor_pos() - m_inital_pos;
+        // entities and constraints got fetched for modification in begin, going through the
+        // non-const accessors here again would make the solver rebuild its systems each frame
+        const auto &cdoc = std::as_const(doc);
         for (auto [entity, point] : m_entities) {
             if (!entity->can_move(doc))
                 continue;
             if (auto en_movable = dynamic_cast<IEntityMovable2D *>(entity)) {
-                const auto &wrkpl =
-                        get_entity<EntityWorkplane>(dynamic_cast<const IEntityInWorkplane &>(*entity).get_workplane());
+                const auto &wrkpl = cdoc.get_entity<EntityWorkplane>(
+                        dynamic_cast<const IEntityInWorkplane &>(*entity).get_workplane());
                 const auto delta2d =
                         wrkpl.project(get_cursor_pos_for_workplane(wrkpl)) - m_inital_pos_wrkpl.at(wrkpl.m_uuid);
                 auto &en_last = *last_doc.m_entities.at(entity->m_uuid);
@@ -106,8 +112,8 @@ ToolResponse ToolMove::update(const ToolArgs &args)
                 en_movable3d->move(en_last, delta, point);
             }
             else if (auto en_movable_initial_pos = dynamic_cast<IEntityMovable2DIntialPos *>(entity)) {
-                const auto &wrkpl =
-                        get_entity<EntityWorkplane>(dynamic_cast<const IEntityInWorkplane &>(*entity).get_workplane());
+                const auto &wrkpl = cdoc.get_entity<EntityWorkplane>(
+                        dynamic_cast<const IEntityInWorkplane &>(*entity).get_workplane());
                 auto &en_last = *last_doc.m_entities.at(entity->m_uuid);
                 en_movable_initial_pos->move(en_last, m_inital_pos_wrkpl.at(wrkpl.m_uuid),
                                              wrkpl.project(get_cursor_pos_for_workplane(wrkpl)), point);
@@ -117,31 +123,29 @@ ToolResponse ToolMove::update(const ToolArgs &args)
         doc.set_group_solve_pending(m_first_group);
         m_core.solve_current(m_dragged_list);
 
-        for (auto sr : m_selection) {
-            if (sr.type == SelectableRef::Type::CONSTRAINT) {
-                auto constraint = doc.m_constraints.at(sr.item).get();
-                auto co_wrkpl = dynamic_cast<const IConstraintWorkplane *>(constraint);
-                auto co_movable = dynamic_cast<IConstraintMovable *>(constraint);
-                if (co_movable) {
-                    auto cdelta = delta;
-                    glm::dvec2 delta2d;
-                    if (co_wrkpl) {
-                        const auto wrkpl_uu = co_wrkpl->get_workplane(get_doc());
-                        if (wrkpl_uu) {
-                            auto &wrkpl = get_entity<EntityWorkplane>(wrkpl_uu);
-                            delta2d = wrkpl.project(m_intf.get_cursor_pos_for_plane(wrkpl.m_origin,
-                                                                                    wrkpl.get_normal_vector()))
-                                      - m_inital_pos_wrkpl.at(wrkpl.m_uuid);
-                            cdelta = wrkpl.transform_relative(delta2d);
-                        }
+        for (auto constraint : m_constraints) {
+            auto co_wrkpl = dynamic_cast<const IConstraintWorkplane *>(constraint);
+            auto co_movable = dynamic_cast<IConstraintMovable *>(constraint);
+            if (co_movable) {
+                auto cdelta = delta;
+                glm::dvec2 delta2d;
+                if (co_wrkpl) {
+                    const auto wrkpl_uu = co_wrkpl->get_workplane(cdoc);
+                    if (wrkpl_uu) {
+                        auto &wrkpl = cdoc.get_entity<EntityWorkplane>(wrkpl_uu);
+                        delta2d = wrkpl.project(m_intf.get_cursor_pos_for_plane(wrkpl.m_origin,
+                                                                                wrkpl.get_normal_vector()))
+                                  - m_inital_pos_wrkpl.at(wrkpl.m_uuid);
+                        cdelta = wrkpl.transform_relative(delta2d);
                     }
-                    auto &co_last = dynamic_cast<const IConstraintMovable &>(*last_doc.m_constraints.at(sr.item));
-                    const auto odelta = (co_movable->get_origin(doc) - co_last.get_origin(last_doc));
-                    if (co_movable->offset_is_in_workplane())
-                        co_movable->set_offset(co_last.get_offset() + glm::dvec3(delta2d, 0) - odelta);
-                    else
-                        co_movable->set_offset(co_last.get_offset() + cdelta - odelta);
                 }
+                auto &co_last =
+                        dynamic_cast<const IConstraintMovable &>(*last_doc.m_constraints.at(constraint->m_uuid));
+                const auto odelta = (co_movable->get_origin(doc) - co_last.get_origin(last_doc));
+                if (co_movable->offset_is_in_workplane())
+                    co_movable->set_offset(co_last.get_offset() + glm::dvec3(delta2d, 0) - odelta);
+                else
+                    co_movable->set_offset(co_last.get_offset() + cdelta - odelta);
             }
         }
 
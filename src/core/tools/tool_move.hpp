@@ -1,10 +1,12 @@
 #include "tool_common.hpp"
 #include "in_tool_action/in_tool_action.hpp"
 #include <map>
+#include <vector>
 
 namespace dune3d {
 
 class Group;
+class Constraint;
 
 class ToolMove : public ToolCommon {
 public:
@@ -40,6 +42,7 @@ private:
     UUID m_first_group;
     UUID m_first_group_render;
     std::set<std::pair<Entity *, unsigned int>> m_entities;
+    std::vector<Constraint *> m_constraints;
     ICore::DraggedList m_dragged_list;
 };
 } // namespace dune3d
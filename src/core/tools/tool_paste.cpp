@@ -51,7 +51,7 @@ ToolResponse ToolPaste::begin(const ToolArgs &args)
                 entity_xlat.emplace(uu, new_entity->m_uuid);
                 m_selection.emplace(SelectableRef::Type::ENTITY, new_entity->m_uuid, new_entity->get_point_for_move());
                 wrkpl = new_entity->m_uuid;
-                doc.m_entities.emplace(new_entity->m_uuid, std::move(new_entity));
+                doc.insert_entity(std::move(new_entity));
                 break;
             }
         }
@@ -103,7 +103,7 @@ ToolResponse ToolPaste::begin(const ToolArgs &args)
 
         entity_xlat.emplace(uu, new_entity->m_uuid);
         m_selection.emplace(SelectableRef::Type::ENTITY, new_entity->m_uuid, new_entity->get_point_for_move());
-        doc.m_entities.emplace(new_entity->m_uuid, std::move(new_entity));
+        doc.insert_entity(std::move(new_entity));
     }
     m_intf.set_canvas_selection_mode(SelectionMode::NORMAL);
 
@@ -148,7 +148,7 @@ ToolResponse ToolPaste::begin(const ToolArgs &args)
             skip = true;
 
         if (!skip)
-            doc.m_constraints.emplace(new_co->m_uuid, std::move(new_co));
+            doc.insert_constraint(std::move(new_co));
     }
 
     set_current_group_generate_pending();
@@ -1,4 +1,5 @@
 #include "document.hpp"
+#include "document_snapshot.hpp"
 #include "nlohmann/json.hpp"
 #include "entity/entity.hpp"
 #include "constraint/constraint.hpp"
@@ -13,13 +14,17 @@
 #include "system/system.hpp"
 #include "logger/logger.hpp"
 #include "logger/log_util.hpp"
+#include <atomic>
+#include <chrono>
 #include <ranges>
 #include <set>
 #include <algorithm>
 #include <iostream>
 #include <glibmm.h>
 #include "util/template_util.hpp"
+#include "util/task_graph.hpp"
 #include "entity/entity_and_point.hpp"
+#include "import_step/imported_step.hpp"
 
 namespace dune3d {
 
@@ -136,10 +141,18 @@ bool Document::apply_version_upgrades()
 
 void Document::erase_invalid()
 {
+    const auto n_constraints = m_constraints.size();
     map_erase_if(m_constraints, [this](auto &x) { return !x.second->is_valid(*this); });
+    if (m_constraints.size() != n_constraints)
+        set_topology_changed();
 }
 
-Document::Document(const Document &other) : m_version(other.m_version)
+Document::Document(const Document &other)
+    : m_version(other.m_version), m_first_group_generate(other.m_first_group_generate),
+      m_first_group_solve(other.m_first_group_solve),
+      m_first_group_update_solid_model(other.m_first_group_update_solid_model),
+      m_snapshot_base(other.m_snapshot_base), m_changed_items(other.m_changed_items),
+      m_changed_groups(other.m_changed_groups)
 {
     for (const auto &[uu, it] : other.m_entities) {
         m_entities.emplace(uu, it->clone());
@@ -153,6 +166,87 @@ Document::Document(const Document &other) : m_version(other.m_version)
     update_groups_sorted();
 }
 
+Document::Document(Document &&other) = default;
+
+Document::Document(const DocumentSnapshot &snapshot)
+    : m_version(snapshot.m_version), m_first_group_generate(snapshot.m_first_group_generate),
+      m_first_group_solve(snapshot.m_first_group_solve),
+      m_first_group_update_solid_model(snapshot.m_first_group_update_solid_model), m_snapshot_base(snapshot.m_id)
+{
+    for (const auto &[uu, it] : snapshot.m_entities) {
+        m_entities.emplace_hint(m_entities.end(), uu, it->clone());
+    }
+    for (const auto &[uu, it] : snapshot.m_constraints) {
+        m_constraints.emplace_hint(m_constraints.end(), uu, it->clone());
+    }
+    for (const auto &[uu, it] : snapshot.m_groups) {
+        m_groups.emplace_hint(m_groups.end(), uu, it->clone());
+    }
+    update_groups_sorted();
+}
+
+namespace {
+template <typename T, typename F>
+void load_snapshot_items(std::map<UUID, std::unique_ptr<T>> &dest,
+                         const std::map<UUID, std::shared_ptr<const T>> &snapshot,
+                         const std::map<UUID, std::shared_ptr<const T>> *base, F is_changed)
+{
+    auto current = std::move(dest);
+    dest.clear();
+    for (const auto &[uu, it] : snapshot) {
+        if (base) {
+            auto it_base = base->find(uu);
+            auto it_current = current.find(uu);
+            if (it_base != base->end() && it_base->second == it && it_current != current.end()
+                && !is_changed(*it_current->second)) {
+                dest.emplace_hint(dest.end(), uu, std::move(it_current->second));
+                continue;
+            }
+        }
+        dest.emplace_hint(dest.end(), uu, it->clone());
+    }
+}
+} // namespace
+
+void Document::load_snapshot(const DocumentSnapshot &snapshot, const DocumentSnapshot *base)
+{
+    // our items only match base's if they didn't change since it was taken
+    if (base && base->m_id != m_snapshot_base)
+        base = nullptr;
+    load_snapshot_items(m_entities, snapshot.m_entities, base ? &base->m_entities : nullptr,
+                        [this](const Entity &en) { return is_item_changed(en.m_uuid, en.m_group); });
+    load_snapshot_items(m_constraints, snapshot.m_constraints, base ? &base->m_constraints : nullptr,
+                        [this](const Constraint &co) { return is_item_changed(co.m_uuid, co.m_group); });
+    m_groups.clear();
+    for (const auto &[uu, it] : snapshot.m_groups) {
+        m_groups.emplace_hint(m_groups.end(), uu, it->clone());
+    }
+    m_version = snapshot.m_version;
+    m_first_group_generate = snapshot.m_first_group_generate;
+    m_first_group_solve = snapshot.m_first_group_solve;
+    m_first_group_update_solid_model = snapshot.m_first_group_update_solid_model;
+    update_groups_sorted();
+    clear_changes(snapshot.m_id);
+}
+
+void Document::set_item_changed(const UUID &uu)
+{
+    if (!m_updating)
+        m_changed_items.insert(uu);
+}
+
+bool Document::is_item_changed(const UUID &uu, const UUID &group) const
+{
+    return m_changed_items.contains(uu) || m_changed_groups.contains(group);
+}
+
+void Document::clear_changes(uint64_t snapshot_base)
+{
+    m_snapshot_base = snapshot_base;
+    m_changed_items.clear();
+    m_changed_groups.clear();
+}
+
 Document Document::new_from_file(const std::filesystem::path &path)
 {
     return Document{load_json_from_file(path), path.parent_path()};
@@ -170,6 +264,8 @@ const std::vector<const Group *> &Document::get_groups_sorted() const
 
 void Document::update_groups_sorted()
 {
+    m_revision = get_next_revision();
+    set_topology_changed();
     m_groups_sorted.clear();
     m_groups_sorted.reserve(m_groups.size());
     for (auto &[uu, it] : m_groups) {
@@ -195,9 +291,27 @@ std::vector<Document::BodyGroups> Document::get_groups_by_body() const
     return r;
 }
 
-void Document::update_pending(const UUID &last_group_to_update_i, const std::vector<EntityAndPoint> &dragged)
+void Document::update_pending(const UUID &last_group_to_update, const std::vector<EntityAndPoint> &dragged,
+                              const CancelCheck &is_cancelled)
+{
+    m_revision = get_next_revision();
+    // updating may change any item of the pending groups
+    const auto first_pending_index = get_first_pending_index();
+    for (auto group : get_groups_sorted()) {
+        if (group->get_index() >= first_pending_index)
+            m_changed_groups.insert(group->m_uuid);
+    }
+    m_updating = true;
+    update_pending_groups(last_group_to_update, dragged, is_cancelled);
+    m_updating = false;
+}
+
+void Document::update_pending_groups(const UUID &last_group_to_update_i, const std::vector<EntityAndPoint> &dragged,
+                                     const CancelCheck &is_cancelled)
 {
     try {
+        if (dragged.empty())
+            m_solver_cache.clear();
         auto groups_sorted = get_groups_sorted();
         if (groups_sorted.empty())
             return;
@@ -216,7 +330,10 @@ void Document::update_pending(const UUID &last_group_to_update_i, const std::vec
         const Group *last_group = nullptr;
         // first pass: generate
         if (m_first_group_generate) {
+            const ItemIndex item_index{*this};
             for (auto group : groups_sorted) {
+                if (is_cancelled && is_cancelled())
+                    return;
                 if (last_group && last_group->m_uuid == last_group_to_update) {
                     // we've seen all groups we needed to see, update to the rest
                     if (m_first_group_generate)
@@ -225,7 +342,7 @@ void Document::update_pending(const UUID &last_group_to_update_i, const std::vec
                 }
                 const auto index = group->get_index();
                 if (index >= first_generate_index) {
-                    generate_group(*group);
+                    generate_group(*group, item_index);
                 }
                 last_group = group;
             }
@@ -236,8 +353,22 @@ void Document::update_pending(const UUID &last_group_to_update_i, const std::vec
             m_first_group_generate = UUID();
 
 
+        // solving and updating solid models doesn't add or remove any items
+        const ItemIndex item_index{*this};
+
+        if (!last_group_to_update && dragged.empty() && get_update_mode() == UpdateMode::PARALLEL) {
+            update_groups_parallel(first_solve_index, first_update_solid_model_index, item_index, is_cancelled);
+            if (is_cancelled && is_cancelled())
+                return;
+            m_first_group_solve = UUID();
+            m_first_group_update_solid_model = UUID();
+            return;
+        }
+
         last_group = nullptr;
         for (auto group : groups_sorted) {
+            if (is_cancelled && is_cancelled())
+                return;
             if (last_group && last_group->m_uuid == last_group_to_update) {
                 // we've seen all groups we needed to see, update to the rest
                 if (m_first_group_solve)
@@ -248,7 +379,7 @@ void Document::update_pending(const UUID &last_group_to_update_i, const std::vec
             }
             const auto index = group->get_index();
             if (index >= first_solve_index) {
-                solve_group(*group, dragged);
+                solve_group(*group, dragged, item_index);
             }
             if (index >= first_update_solid_model_index) {
                 update_solid_model(*group);
@@ -263,25 +394,237 @@ void Document::update_pending(const UUID &last_group_to_update_i, const std::vec
     CATCH_LOG(Logger::Level::CRITICAL, "error updating document", Logger::Domain::DOCUMENT)
 }
 
-void Document::generate_group(Group &group)
+static std::atomic<Document::UpdateMode> s_update_mode = Document::UpdateMode::PARALLEL;
+
+void Document::set_update_mode(UpdateMode mode)
+{
+    s_update_mode = mode;
+}
+
+Document::UpdateMode Document::get_update_mode()
+{
+    return s_update_mode;
+}
+
+void Document::update_groups_parallel(int first_solve_index, int first_update_solid_model_index,
+                                      const ItemIndex &item_index, const CancelCheck &is_cancelled)
+{
+    // Each group gets a solve and a solid model task. Solving depends on the
+    // groups whose entities its System reads, since solving writes the params of
+    // the group's own entities. The solid model additionally depends on the
+    // previous solid model in the same body.
+    TaskGraph graph;
+    std::map<UUID, TaskGraph::TaskID> solve_tasks;
+    std::map<UUID, TaskGraph::TaskID> solid_model_tasks;
+    std::map<const Group *, TaskGraph::TaskID> last_solid_model_task_by_body;
+    const Group *body_group = nullptr;
+    for (auto group : get_groups_sorted()) {
+        if (group->m_body)
+            body_group = group;
+        const auto index = group->get_index();
+        const bool solve = index >= first_solve_index;
+        const bool solid_model = index >= first_update_solid_model_index;
+        if (!solve && !solid_model)
+            continue;
+
+        auto deps = group->get_referenced_groups(*this);
+        {
+            auto req = group->get_required_groups(*this);
+            deps.insert(req.begin(), req.end());
+        }
+        if (solve) {
+            auto read = System::get_groups_read(*this, group->m_uuid, item_index);
+            deps.insert(read.begin(), read.end());
+        }
+
+        const auto task_solve = graph.add_task([this, group, solve, &item_index] {
+            if (solve)
+                solve_group(*group, {}, item_index);
+        });
+        const auto task_solid_model = graph.add_task([this, group, solid_model] {
+            if (solid_model)
+                update_solid_model(*group);
+        });
+        graph.add_dependency(task_solid_model, task_solve);
+        for (const auto &dep : deps) {
+            if (dep == group->m_uuid)
+                continue;
+            if (solve_tasks.contains(dep))
+                graph.add_dependency(task_solve, solve_tasks.at(dep));
+            if (solid_model_tasks.contains(dep))
+                graph.add_dependency(task_solid_model, solid_model_tasks.at(dep));
+        }
+        if (last_solid_model_task_by_body.contains(body_group))
+            graph.add_dependency(task_solid_model, last_solid_model_task_by_body.at(body_group));
+        last_solid_model_task_by_body[body_group] = task_solid_model;
+
+        solve_tasks.emplace(group->m_uuid, task_solve);
+        solid_model_tasks.emplace(group->m_uuid, task_solid_model);
+    }
+    graph.run(TaskGraph::get_default_n_threads(), is_cancelled);
+}
+
+bool Document::has_pending() const
+{
+    return m_first_group_generate || m_first_group_solve || m_first_group_update_solid_model;
+}
+
+int Document::get_first_pending_index() const
+{
+    int index = INT_MAX;
+    for (const auto &uu : {m_first_group_generate, m_first_group_solve, m_first_group_update_solid_model}) {
+        if (m_groups.contains(uu))
+            index = std::min(index, get_group(uu).get_index());
+    }
+    return index;
+}
+
+bool Document::is_group_update_pending(const UUID &group_uu) const
+{
+    return get_group(group_uu).get_index() >= get_first_pending_index();
+}
+
+uint64_t Document::get_next_revision()
+{
+    static std::atomic<uint64_t> s_revision = 0;
+    return ++s_revision;
+}
+
+void Document::set_topology_changed()
+{
+    m_topology_generation = get_next_revision();
+    m_solver_cache.clear();
+}
+
+void Document::set_item_modified(const UUID &uu)
+{
+    // updating only writes back parameters and marks whole groups as changed
+    if (m_updating)
+        return;
+    set_item_changed(uu);
+    set_topology_changed();
+}
+
+Entity &Document::insert_entity(std::unique_ptr<Entity> entity)
+{
+    const auto uu = entity->m_uuid;
+    auto &r = *m_entities.emplace(uu, std::move(entity)).first->second;
+    set_topology_changed();
+    set_item_changed(uu);
+    return r;
+}
+
+Constraint &Document::insert_constraint(std::unique_ptr<Constraint> constraint)
+{
+    const auto uu = constraint->m_uuid;
+    auto &r = *m_constraints.emplace(uu, std::move(constraint)).first->second;
+    set_topology_changed();
+    set_item_changed(uu);
+    return r;
+}
+
+void Document::erase_entity(const UUID &uu)
+{
+    if (m_entities.erase(uu))
+        set_topology_changed();
+}
+
+void Document::erase_constraint(const UUID &uu)
 {
+    if (m_constraints.erase(uu))
+        set_topology_changed();
+}
+
+void Document::take_update_results(Document &&updated)
+{
+    std::set<UUID> updated_groups;
+    const auto first_index = get_first_pending_index();
+    for (auto group : get_groups_sorted()) {
+        if (group->get_index() >= first_index)
+            updated_groups.insert(group->m_uuid);
+    }
+
+    // generating may have added or removed entities, so take over all items of the updated groups
+    map_erase_if(m_entities, [&updated_groups](auto &x) { return updated_groups.contains(x.second->m_group); });
+    for (auto &[uu, en] : updated.m_entities) {
+        if (updated_groups.contains(en->m_group))
+            m_entities.emplace(uu, std::move(en));
+    }
+    map_erase_if(m_constraints, [&updated_groups](auto &x) { return updated_groups.contains(x.second->m_group); });
+    for (auto &[uu, co] : updated.m_constraints) {
+        if (updated_groups.contains(co->m_group))
+            m_constraints.emplace(uu, std::move(co));
+    }
+    for (const auto &uu : updated_groups) {
+        m_groups.at(uu) = std::move(updated.m_groups.at(uu));
+        m_changed_groups.insert(uu);
+    }
+    update_groups_sorted();
+
+    m_first_group_generate = updated.m_first_group_generate;
+    m_first_group_solve = updated.m_first_group_solve;
+    m_first_group_update_solid_model = updated.m_first_group_update_solid_model;
+    m_solver_cache.clear();
+}
+
+class Document::UpdateStepTimer {
+public:
+    UpdateStepTimer(const Document &doc, const Group &group, UpdateStep step)
+        : m_cb(doc.m_update_step_callback), m_group(group), m_step(step)
+    {
+        if (m_cb)
+            m_start = std::chrono::steady_clock::now();
+    }
+
+    ~UpdateStepTimer()
+    {
+        if (!m_cb)
+            return;
+        const std::chrono::duration<double> duration = std::chrono::steady_clock::now() - m_start;
+        m_cb(m_group, m_step, duration.count());
+    }
+
+private:
+    const UpdateStepCallback &m_cb;
+    const Group &m_group;
+    const UpdateStep m_step;
+    std::chrono::steady_clock::time_point m_start;
+};
+
+void Document::set_update_step_callback(UpdateStepCallback cb)
+{
+    m_update_step_callback = std::move(cb);
+}
+
+void Document::generate_group(Group &group, const ItemIndex &item_index)
+{
+    UpdateStepTimer timer{*this, group, UpdateStep::GENERATE};
     if (auto gg = dynamic_cast<IGroupGenerate *>(&group)) {
-        for (auto &[uu, it] : m_entities) {
-            if (it->m_group == group.m_uuid && it->m_kind == ItemKind::GENRERATED) {
+        // generating only adds entities to the group, so the ones that are
+        // already there are all that can become stale
+        const auto &entities = item_index.get_entities(group.m_uuid);
+        for (auto it : entities) {
+            if (it->m_kind == ItemKind::GENRERATED) {
                 it->m_kind = ItemKind::GENRERATED_STALE;
                 it->m_generated_from = UUID();
             }
         }
         gg->generate(*this);
-        map_erase_if(m_entities, [&group](auto &x) {
-            return x.second->m_group == group.m_uuid && x.second->m_kind == ItemKind::GENRERATED_STALE;
-        });
+        std::vector<UUID> stale;
+        for (auto it : entities) {
+            if (it->m_kind == ItemKind::GENRERATED_STALE)
+                stale.push_back(it->m_uuid);
+        }
+        for (const auto &uu : stale)
+            m_entities.erase(uu);
+        set_topology_changed();
     }
 }
 
 
 void Document::update_solid_model(Group &group)
 {
+    UpdateStepTimer timer{*this, group, UpdateStep::UPDATE_SOLID_MODEL};
     if (auto gr = dynamic_cast<IGroupSolidModel *>(&group))
         gr->update_solid_model(*this);
 }
@@ -292,8 +635,10 @@ static std::string make_json_link(const std::string &label, const json &j)
 }
 
 
-void Document::solve_group(Group &group, const std::vector<EntityAndPoint> &dragged)
+void Document::solve_group(Group &group, const std::vector<EntityAndPoint> &dragged,
+                           const ItemIndex &item_index)
 {
+    UpdateStepTimer timer{*this, group, UpdateStep::SOLVE};
     if (group.get_type() == Group::Type::REFERENCE) {
         group.m_dof = 0;
         group.m_solve_result = SolveResult::OKAY;
@@ -301,7 +646,18 @@ void Document::solve_group(Group &group, const std::vector<EntityAndPoint> &drag
     }
     group.m_solve_messages.clear();
 
-    System system{*this, group.m_uuid};
+    std::unique_ptr<System> system_cached;
+    if (dragged.size())
+        system_cached = m_solver_cache.take(*this, group.m_uuid, dragged);
+    if (system_cached) {
+        system_cached->resume();
+    }
+    else {
+        system_cached = std::make_unique<System>(*this, group.m_uuid, UUID(), &item_index);
+        if (dragged.size())
+            system_cached->set_reusable();
+    }
+    auto &system = *system_cached;
     for (const auto &[en, pt] : dragged) {
         system.add_dragged(en, pt);
     }
@@ -338,6 +694,58 @@ void Document::solve_group(Group &group, const std::vector<EntityAndPoint> &drag
     }
     group.m_bad_constraints.reset();
     system.update_document();
+    if (dragged.size()) {
+        system.suspend();
+        m_solver_cache.put(*this, group.m_uuid, dragged, std::move(system_cached));
+    }
+}
+
+Document::SolverCache::SolverCache() = default;
+
+Document::SolverCache::SolverCache(const SolverCache &)
+{
+}
+
+Document::SolverCache::SolverCache(SolverCache &&)
+{
+}
+
+Document::SolverCache::~SolverCache() = default;
+
+std::unique_ptr<System> Document::SolverCache::take(const Document &doc, const UUID &group,
+                                                    const std::vector<EntityAndPoint> &dragged)
+{
+    if (dragged != m_dragged)
+        return nullptr;
+    auto it = m_items.find(group);
+    if (it == m_items.end())
+        return nullptr;
+    auto item = std::move(it->second);
+    m_items.erase(it);
+    if (item.topology_generation != doc.get_topology_generation())
+        return nullptr;
+    return std::move(item.system);
+}
+
+void Document::SolverCache::put(const Document &doc, const UUID &group, const std::vector<EntityAndPoint> &dragged,
+                                std::unique_ptr<System> system)
+{
+    if (dragged != m_dragged) {
+        m_items.clear();
+        m_dragged = dragged;
+    }
+    m_items.insert_or_assign(group, Item{std::move(system), doc.get_topology_generation()});
+}
+
+void Document::SolverCache::clear()
+{
+    m_items.clear();
+    m_dragged.clear();
+}
+
+void Document::clear_solver_cache()
+{
+    m_solver_cache.clear();
 }
 
 void Document::insert_group(std::unique_ptr<Group> new_group, const UUID &after)
@@ -415,6 +823,53 @@ void ItemsToDelete::append(const ItemsToDelete &other)
     constraints.insert(other.constraints.begin(), other.constraints.end());
 }
 
+Document::ItemIndex::ItemIndex(const Document &doc, References refs)
+{
+    for (const auto &[uu, en] : doc.m_entities) {
+        m_entities[en->m_group].push_back(en.get());
+        if (refs == References::YES) {
+            for (const auto &ref : en->get_referenced_entities())
+                m_referencing_entities[ref].push_back(en.get());
+        }
+    }
+    for (const auto &[uu, co] : doc.m_constraints) {
+        m_constraints[co->m_group].push_back(co.get());
+        if (refs == References::YES) {
+            for (const auto &ref : co->get_referenced_entities())
+                m_referencing_constraints[ref].push_back(co.get());
+        }
+    }
+}
+
+template <typename T>
+static const std::vector<T *> &find_or_empty(const std::map<UUID, std::vector<T *>> &map, const UUID &uu)
+{
+    static const std::vector<T *> empty;
+    if (auto it = map.find(uu); it != map.end())
+        return it->second;
+    return empty;
+}
+
+const std::vector<Entity *> &Document::ItemIndex::get_entities(const UUID &group) const
+{
+    return find_or_empty(m_entities, group);
+}
+
+const std::vector<Constraint *> &Document::ItemIndex::get_constraints(const UUID &group) const
+{
+    return find_or_empty(m_constraints, group);
+}
+
+const std::vector<Entity *> &Document::ItemIndex::get_referencing_entities(const UUID &entity) const
+{
+    return find_or_empty(m_referencing_entities, entity);
+}
+
+const std::vector<Constraint *> &Document::ItemIndex::get_referencing_constraints(const UUID &entity) const
+{
+    return find_or_empty(m_referencing_constraints, entity);
+}
+
 static void subtract_set(std::set<UUID> &s, const std::set<UUID> &sub)
 {
     for (const auto &it : sub) {
@@ -450,38 +905,28 @@ ItemsToDelete Document::get_additional_items_to_delete(const ItemsToDelete &item
 {
     ItemsToDelete items = items_initial;
 
+    const ItemIndex item_index{*this, ItemIndex::References::YES};
+
     while (1) {
         auto size_before = items.size();
-        for (const auto &[uu, it] : m_entities) {
-            if (items.entities.contains(uu))
-                continue;
-            if (items.groups.contains(it->m_group)) {
-                items.entities.insert(uu);
-                continue;
-            }
-            auto refs = it->get_referenced_entities();
-            for (auto &ref : refs) {
-                if (items.entities.contains(ref)) {
-                    items.entities.insert(uu);
-                    break;
-                }
-            }
+        for (const auto &group : items.groups) {
+            for (auto en : item_index.get_entities(group))
+                items.entities.insert(en->m_uuid);
+            for (auto co : item_index.get_constraints(group))
+                items.constraints.insert(co->m_uuid);
         }
 
-        for (const auto &[uu, it] : m_constraints) {
-            if (items.constraints.contains(uu))
-                continue;
-            if (items.groups.contains(it->m_group)) {
-                items.constraints.insert(uu);
-                continue;
-            }
-            auto refs = it->get_referenced_entities();
-            for (auto &ref : refs) {
-                if (items.entities.contains(ref)) {
-                    items.constraints.insert(uu);
-                    break;
-                }
+        // everything referencing an entity that gets deleted needs to be deleted as well
+        std::vector<UUID> todo(items.entities.begin(), items.entities.end());
+        while (todo.size()) {
+            const auto uu = todo.back();
+            todo.pop_back();
+            for (auto en : item_index.get_referencing_entities(uu)) {
+                if (items.entities.insert(en->m_uuid).second)
+                    todo.push_back(en->m_uuid);
             }
+            for (auto co : item_index.get_referencing_constraints(uu))
+                items.constraints.insert(co->m_uuid);
         }
 
         for (const auto &[uu, it] : m_groups) {
@@ -585,6 +1030,7 @@ void Document::update_group_if_less(UUID &uu, const UUID &new_group)
 
 void Document::set_group_generate_pending(const UUID &group)
 {
+    set_topology_changed();
     update_group_if_less(m_first_group_generate, group);
     set_group_solve_pending(group);
 }
@@ -597,9 +1043,26 @@ void Document::set_group_solve_pending(const UUID &group)
 
 void Document::set_group_update_solid_model_pending(const UUID &group)
 {
+    m_revision = get_next_revision();
     update_group_if_less(m_first_group_update_solid_model, group);
 }
 
+bool Document::set_step_solid_models_pending()
+{
+    bool r = false;
+    for (const auto &[uu, group] : m_groups) {
+        auto sketch = dynamic_cast<const GroupSketch *>(group.get());
+        if (!sketch || is_group_update_pending(uu))
+            continue;
+        if (std::ranges::any_of(sketch->m_pending_step_imports,
+                                [](const auto &imported) { return imported->ready.load(); })) {
+            set_group_update_solid_model_pending(uu);
+            r = true;
+        }
+    }
+    return r;
+}
+
 UUID Document::get_group_after(const UUID &group_uu, MoveGroup dir) const
 {
     auto &group = get_group(group_uu);
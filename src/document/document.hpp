@@ -5,6 +5,9 @@
 #include "nlohmann/json_fwd.hpp"
 #include <filesystem>
 #include <set>
+#include <vector>
+#include <cstdint>
+#include <functional>
 #include <glm/glm.hpp>
 #include "util/file_version.hpp"
 #include "entity/entity_and_point.hpp"
@@ -16,6 +19,8 @@ class Constraint;
 class Group;
 class Body;
 class GroupReference;
+class System;
+class DocumentSnapshot;
 enum class GroupType;
 
 struct ItemsToDelete {
@@ -35,6 +40,13 @@ public:
     explicit Document(const json &j, const std::filesystem::path &containing_dir);
     static Document new_from_file(const std::filesystem::path &path);
     Document(const Document &other);
+    Document(Document &&other);
+    explicit Document(const DocumentSnapshot &snapshot);
+
+    // Replaces the content with the snapshot's. Items that base shares with the
+    // snapshot and that didn't change since base was taken are kept rather than
+    // being copied again, so that undo and redo only copy what they change.
+    void load_snapshot(const DocumentSnapshot &snapshot, const DocumentSnapshot *base);
 
     std::map<UUID, std::unique_ptr<Entity>> m_entities;
     std::map<UUID, std::unique_ptr<Constraint>> m_constraints;
@@ -47,12 +59,16 @@ public:
         auto en = std::make_unique<T>(uu);
         auto p = en.get();
         m_entities.emplace(uu, std::move(en));
+        set_topology_changed();
+        set_item_changed(uu);
         return *p;
     }
 
     template <typename T = Entity> T &get_entity(const UUID &uu)
     {
-        return dynamic_cast<T &>(*m_entities.at(uu));
+        auto &r = dynamic_cast<T &>(*m_entities.at(uu));
+        set_item_modified(uu);
+        return r;
     }
 
     template <typename T = Entity> T *get_entity_ptr(const UUID &uu)
@@ -60,8 +76,8 @@ public:
         auto it = m_entities.find(uu);
         if (it == m_entities.end())
             return nullptr;
-        else
-            return dynamic_cast<T *>(it->second.get());
+        set_item_modified(uu);
+        return dynamic_cast<T *>(it->second.get());
     }
 
     template <typename T> T &get_or_add_entity(const UUID &uu, bool *was_added = nullptr)
@@ -69,6 +85,7 @@ public:
         if (m_entities.count(uu)) {
             if (was_added)
                 *was_added = false;
+            set_item_modified(uu);
             return dynamic_cast<T &>(*m_entities.at(uu));
         }
         else {
@@ -78,6 +95,13 @@ public:
         }
     }
 
+    // for items that aren't made through add_entity or add_constraint, such as
+    // clones, these don't replace existing items
+    Entity &insert_entity(std::unique_ptr<Entity> entity);
+    Constraint &insert_constraint(std::unique_ptr<Constraint> constraint);
+    void erase_entity(const UUID &uu);
+    void erase_constraint(const UUID &uu);
+
     template <typename T = Entity> const T &get_entity(const UUID &uu) const
     {
         return dynamic_cast<const T &>(*m_entities.at(uu));
@@ -99,7 +123,9 @@ public:
 
     template <typename T = Constraint> T &get_constraint(const UUID &uu)
     {
-        return dynamic_cast<T &>(*m_constraints.at(uu));
+        auto &r = dynamic_cast<T &>(*m_constraints.at(uu));
+        set_item_modified(uu);
+        return r;
     }
 
     template <typename T = Constraint> T *get_constraint_ptr(const UUID &uu)
@@ -107,8 +133,8 @@ public:
         auto it = m_constraints.find(uu);
         if (it == m_constraints.end())
             return nullptr;
-        else
-            return dynamic_cast<T *>(it->second.get());
+        set_item_modified(uu);
+        return dynamic_cast<T *>(it->second.get());
     }
 
     template <typename T = Constraint> const T *get_constraint_ptr(const UUID &uu) const
@@ -125,6 +151,8 @@ public:
         auto en = std::make_unique<T>(uu);
         auto p = en.get();
         m_constraints.emplace(uu, std::move(en));
+        set_topology_changed();
+        set_item_changed(uu);
         return *p;
     }
 
@@ -184,12 +212,64 @@ public:
     UUID get_group_rel(const UUID &group, int delta) const;
 
     void erase_invalid();
-    void update_pending(const UUID &last_group = UUID(), const std::vector<EntityAndPoint> &dragged = {});
+    using CancelCheck = std::function<bool()>;
+    void update_pending(const UUID &last_group = UUID(), const std::vector<EntityAndPoint> &dragged = {},
+                        const CancelCheck &is_cancelled = nullptr);
+    bool has_pending() const;
+
+    // independent groups get solved and rebuilt concurrently unless set to SERIAL
+    enum class UpdateMode { SERIAL, PARALLEL };
+    static void set_update_mode(UpdateMode mode);
+    static UpdateMode get_update_mode();
+
+    bool is_group_update_pending(const UUID &group) const;
+
+    // Changes whenever something that needs updating changes and is never the same
+    // for two documents, so that a copy can be checked for having been made from
+    // the current state.
+    uint64_t get_revision() const
+    {
+        return m_revision;
+    }
+
+    // Changes whenever entities or constraints get added, removed or may have
+    // been modified through a non-const accessor, e.g. to rewire what a
+    // constraint references. Add and remove items through the Document rather
+    // than through m_entities or m_constraints, so that this stays accurate.
+    uint64_t get_topology_generation() const
+    {
+        return m_topology_generation;
+    }
+
+    // Records that an item may have changed, so that the next snapshot copies it
+    // instead of sharing it with the previous one. The non-const accessors take
+    // care of this, code that modifies m_entities or m_constraints directly or
+    // modifies items through references it kept around needs to call this.
+    void set_item_changed(const UUID &uu);
+
+    // Takes over what updating a copy made at the current revision produced:
+    // solve results, parameters, generated entities and solid models. Only the
+    // groups that were pending are touched, everything else stays as it is.
+    void take_update_results(Document &&updated);
+
+    // gets called after each step of updating a group, possibly from
+    // several threads at once when updating in parallel
+    enum class UpdateStep { GENERATE, SOLVE, UPDATE_SOLID_MODEL };
+    using UpdateStepCallback = std::function<void(const Group &group, UpdateStep step, double seconds)>;
+    void set_update_step_callback(UpdateStepCallback cb);
+
+    // drops the solver state kept around while dragging
+    void clear_solver_cache();
 
     void set_group_generate_pending(const UUID &group);
     void set_group_solve_pending(const UUID &group);
     void set_group_update_solid_model_pending(const UUID &group);
 
+    // Solid models leave out STEP imports that aren't ready yet. Marks the solid
+    // models of groups that are missing imports that are ready by now as pending,
+    // returns true if there were any.
+    bool set_step_solid_models_pending();
+
     enum class MoveGroup { UP, DOWN, END_OF_BODY, END_OF_DOCUMENT };
     UUID get_group_after(const UUID &group, MoveGroup dir) const;
 
@@ -200,6 +280,28 @@ public:
 
     std::set<const Constraint *> find_constraints(const std::set<EntityAndPoint> &enps) const;
 
+    // Entities and constraints by group, collected in a single pass, so that going
+    // over many groups doesn't need to go over all items for each of them.
+    // Becomes stale once items get added, deleted or moved to another group.
+    class ItemIndex {
+    public:
+        enum class References { NO, YES };
+        explicit ItemIndex(const Document &doc, References refs = References::NO);
+
+        const std::vector<Entity *> &get_entities(const UUID &group) const;
+        const std::vector<Constraint *> &get_constraints(const UUID &group) const;
+
+        // only available with References::YES
+        const std::vector<Entity *> &get_referencing_entities(const UUID &entity) const;
+        const std::vector<Constraint *> &get_referencing_constraints(const UUID &entity) const;
+
+    private:
+        std::map<UUID, std::vector<Entity *>> m_entities;
+        std::map<UUID, std::vector<Constraint *>> m_constraints;
+        std::map<UUID, std::vector<Entity *>> m_referencing_entities;
+        std::map<UUID, std::vector<Constraint *>> m_referencing_constraints;
+    };
+
     std::string find_next_group_name(GroupType type) const;
 
     const GroupReference &get_reference_group() const;
@@ -210,6 +312,7 @@ public:
     ~Document();
 
 private:
+    friend class DocumentSnapshot;
     std::map<UUID, std::unique_ptr<Group>> m_groups;
     std::vector<Group *> m_groups_sorted;
     std::vector<const Group *> m_groups_sorted_const;
@@ -218,10 +321,63 @@ private:
     UUID m_first_group_generate;
     UUID m_first_group_solve;
     UUID m_first_group_update_solid_model;
+    int get_first_pending_index() const;
+
+    static uint64_t get_next_revision();
+    uint64_t m_revision = get_next_revision();
+    uint64_t m_topology_generation = get_next_revision();
+
+    // what changed since the snapshot with this ID was taken, see DocumentSnapshot
+    uint64_t m_snapshot_base = 0;
+    std::set<UUID> m_changed_items;
+    std::set<UUID> m_changed_groups;
+    // updating marks the groups it updates instead, this also keeps the threads
+    // updating in parallel from recording changes at the same time
+    bool m_updating = false;
+    void set_topology_changed();
+    // for the non-const accessors, the item may get modified in any way
+    void set_item_modified(const UUID &uu);
+    bool is_item_changed(const UUID &uu, const UUID &group) const;
+    void clear_changes(uint64_t snapshot_base);
+
+    // Systems of the groups solved while dragging, so that subsequent drag
+    // frames only need to update parameter values rather than rebuilding them
+    class SolverCache {
+    public:
+        SolverCache();
+        // Systems refer to the document they were created for, so copies start out empty
+        SolverCache(const SolverCache &);
+        SolverCache(SolverCache &&);
+        ~SolverCache();
+
+        std::unique_ptr<System> take(const Document &doc, const UUID &group,
+                                     const std::vector<EntityAndPoint> &dragged);
+        void put(const Document &doc, const UUID &group, const std::vector<EntityAndPoint> &dragged,
+                 std::unique_ptr<System> system);
+        void clear();
+
+    private:
+        struct Item {
+            std::unique_ptr<System> system;
+            // Systems point at the document's entities, so they're only
+            // valid as long as no items got added or removed
+            uint64_t topology_generation;
+        };
+        std::map<UUID, Item> m_items;
+        std::vector<EntityAndPoint> m_dragged;
+    };
+    SolverCache m_solver_cache;
+
+    UpdateStepCallback m_update_step_callback;
+    class UpdateStepTimer;
 
-    void generate_group(Group &group);
-    void solve_group(Group &group, const std::vector<EntityAndPoint> &dragged);
+    void generate_group(Group &group, const ItemIndex &item_index);
+    void solve_group(Group &group, const std::vector<EntityAndPoint> &dragged, const ItemIndex &item_index);
     void update_solid_model(Group &group);
+    void update_pending_groups(const UUID &last_group, const std::vector<EntityAndPoint> &dragged,
+                               const CancelCheck &is_cancelled);
+    void update_groups_parallel(int first_solve_index, int first_update_solid_model_index,
+                                const ItemIndex &item_index, const CancelCheck &is_cancelled);
 
     void update_group_if_less(UUID &uu, const UUID &new_group);
 
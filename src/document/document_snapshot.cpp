@@ -0,0 +1,65 @@
+#include "document_snapshot.hpp"
+#include "document.hpp"
+#include "entity/entity.hpp"
+#include "constraint/constraint.hpp"
+#include "group/group.hpp"
+#include "logger/logger.hpp"
+#include <atomic>
+
+namespace dune3d {
+
+namespace {
+
+uint64_t get_next_id()
+{
+    static std::atomic<uint64_t> s_id = 0;
+    return ++s_id;
+}
+
+template <typename T, typename F>
+void snapshot_items(std::map<UUID, std::shared_ptr<const T>> &dest, const std::map<UUID, std::unique_ptr<T>> &src,
+                    const std::map<UUID, std::shared_ptr<const T>> *previous, F is_changed)
+{
+    for (const auto &[uu, it] : src) {
+        if (previous && !is_changed(*it)) {
+            auto prev = previous->find(uu);
+            if (prev != previous->end()) {
+#ifndef NDEBUG
+                // catches items modified without going through the non-const accessors
+                // or set_item_changed, these would otherwise be missing from the history
+                if (prev->second->serialize() != it->serialize()) {
+                    Logger::log_critical("item changed without being recorded as changed", Logger::Domain::DOCUMENT,
+                                         (std::string)uu);
+                    dest.emplace_hint(dest.end(), uu, it->clone());
+                    continue;
+                }
+#endif
+                dest.emplace_hint(dest.end(), uu, prev->second);
+                continue;
+            }
+        }
+        dest.emplace_hint(dest.end(), uu, it->clone());
+    }
+}
+
+} // namespace
+
+DocumentSnapshot::DocumentSnapshot(Document &doc, const DocumentSnapshot *previous)
+    : m_version(doc.m_version), m_first_group_generate(doc.m_first_group_generate),
+      m_first_group_solve(doc.m_first_group_solve),
+      m_first_group_update_solid_model(doc.m_first_group_update_solid_model), m_id(get_next_id())
+{
+    // what doc recorded is only relative to the snapshot it was taken from or last snapshotted to
+    if (previous && previous->m_id != doc.m_snapshot_base)
+        previous = nullptr;
+    snapshot_items(m_entities, doc.m_entities, previous ? &previous->m_entities : nullptr,
+                   [&doc](const Entity &en) { return doc.is_item_changed(en.m_uuid, en.m_group); });
+    snapshot_items(m_constraints, doc.m_constraints, previous ? &previous->m_constraints : nullptr,
+                   [&doc](const Constraint &co) { return doc.is_item_changed(co.m_uuid, co.m_group); });
+    for (const auto &[uu, it] : doc.m_groups) {
+        m_groups.emplace_hint(m_groups.end(), uu, it->clone());
+    }
+    doc.clear_changes(m_id);
+}
+
+} // namespace dune3d
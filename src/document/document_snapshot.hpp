@@ -0,0 +1,36 @@
+#pragma once
+#include "util/uuid.hpp"
+#include "util/file_version.hpp"
+#include <cstdint>
+#include <map>
+#include <memory>
+
+namespace dune3d {
+class Document;
+class Entity;
+class Constraint;
+class Group;
+
+// Immutable copy of a document for the undo history. Entities and constraints
+// that didn't change since the previous snapshot are shared with it rather
+// than cloned, so that small edits only cost memory for what they changed.
+class DocumentSnapshot {
+public:
+    // Which items changed is what doc recorded since previous was taken, so this
+    // resets doc's record to start out from the new snapshot.
+    DocumentSnapshot(Document &doc, const DocumentSnapshot *previous);
+
+    std::map<UUID, std::shared_ptr<const Entity>> m_entities;
+    std::map<UUID, std::shared_ptr<const Constraint>> m_constraints;
+    // groups are few and carry solve results, they share their solid models anyway
+    std::map<UUID, std::shared_ptr<const Group>> m_groups;
+
+    FileVersion m_version;
+    UUID m_first_group_generate;
+    UUID m_first_group_solve;
+    UUID m_first_group_update_solid_model;
+
+    const uint64_t m_id;
+};
+
+} // namespace dune3d
@@ -27,6 +27,7 @@ void export_paths(const std::filesystem::path &filename, const Document &doc, co
     ctx->set_source_rgb(0, 0, 0);
     ctx->set_line_width(0.1);
 
+    const Document::ItemIndex item_index{doc};
     for (auto group : groups_sorted) {
         if (!group->m_active_wrkpl)
             continue;
@@ -37,7 +38,7 @@ void export_paths(const std::filesystem::path &filename, const Document &doc, co
         if (group_filter && !group_filter(*group))
             continue;
 
-        const auto paths = paths::Paths::from_document(doc, group->m_active_wrkpl, group->m_uuid);
+        const auto paths = paths::Paths::from_document(doc, group->m_active_wrkpl, group->m_uuid, &item_index);
 
         if (paths.paths.size() == 0)
             continue;
@@ -35,4 +35,9 @@ const SolidModel *GroupLocalOperation::get_solid_model() const
     return m_solid_model.get();
 }
 
+std::shared_ptr<const SolidModel> GroupLocalOperation::get_solid_model_shared() const
+{
+    return m_solid_model;
+}
+
 } // namespace dune3d
@@ -37,5 +37,6 @@ public:
     std::shared_ptr<const SolidModel> m_solid_model;
 
     const SolidModel *get_solid_model() const override;
+    std::shared_ptr<const SolidModel> get_solid_model_shared() const override;
 };
 } // namespace dune3d
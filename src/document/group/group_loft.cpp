@@ -42,6 +42,11 @@ const SolidModel *GroupLoft::get_solid_model() const
     return m_solid_model.get();
 }
 
+std::shared_ptr<const SolidModel> GroupLoft::get_solid_model_shared() const
+{
+    return m_solid_model;
+}
+
 std::set<UUID> GroupLoft::get_referenced_entities(const Document &doc) const
 {
     auto r = Group::get_referenced_entities(doc);
@@ -44,6 +44,7 @@ public:
     }
 
     const SolidModel *get_solid_model() const override;
+    std::shared_ptr<const SolidModel> get_solid_model_shared() const override;
 
     void update_solid_model(const Document &doc) override;
 
@@ -54,6 +54,11 @@ const SolidModel *GroupReplicate::get_solid_model() const
     return m_solid_model.get();
 }
 
+std::shared_ptr<const SolidModel> GroupReplicate::get_solid_model_shared() const
+{
+    return m_solid_model;
+}
+
 UUID GroupReplicate::get_entity_uuid(const UUID &uu, unsigned int instance) const
 {
     return hash_uuids("dee4fd38-6aa6-414f-bd45-524cf97b860b", {m_uuid, uu},
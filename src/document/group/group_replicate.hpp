@@ -40,6 +40,7 @@ public:
     std::shared_ptr<const SolidModel> m_solid_model;
 
     const SolidModel *get_solid_model() const override;
+    std::shared_ptr<const SolidModel> get_solid_model_shared() const override;
 
     UUID get_entity_uuid(const UUID &uu, unsigned int instance) const;
 
@@ -30,6 +30,11 @@ const SolidModel *GroupSketch::get_solid_model() const
     return m_solid_model.get();
 }
 
+std::shared_ptr<const SolidModel> GroupSketch::get_solid_model_shared() const
+{
+    return m_solid_model;
+}
+
 void GroupSketch::update_solid_model(const Document &doc)
 {
     m_solid_model = SolidModel::create(doc, *this);
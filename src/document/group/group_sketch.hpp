@@ -1,8 +1,12 @@
 #pragma once
 #include "group.hpp"
 #include "igroup_solid_model.hpp"
+#include <memory>
+#include <vector>
 
 namespace dune3d {
+class ImportedSTEP;
+
 class GroupSketch : public Group, public IGroupSolidModel {
 public:
     explicit GroupSketch(const UUID &uu);
@@ -17,6 +21,8 @@ public:
 
 
     std::shared_ptr<const SolidModel> m_solid_model;
+    // STEP imports that weren't ready when the solid model got built and thus are missing from it
+    std::vector<std::shared_ptr<const ImportedSTEP>> m_pending_step_imports;
 
     Operation m_operation = Operation::UNION;
     Operation get_operation() const override
@@ -29,6 +35,7 @@ public:
     }
 
     const SolidModel *get_solid_model() const override;
+    std::shared_ptr<const SolidModel> get_solid_model_shared() const override;
     void update_solid_model(const Document &doc) override;
 };
 
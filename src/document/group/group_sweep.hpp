@@ -36,6 +36,7 @@ public:
     }
 
     const SolidModel *get_solid_model() const override;
+    std::shared_ptr<const SolidModel> get_solid_model_shared() const override;
 
     std::list<GroupStatusMessage> m_sweep_messages;
     std::list<GroupStatusMessage> get_messages() const override;
@@ -1,4 +1,5 @@
 #pragma once
+#include <memory>
 
 namespace dune3d {
 class Document;
@@ -8,6 +9,8 @@ class SolidModelOcc;
 class IGroupSolidModel {
 public:
     virtual const SolidModel *get_solid_model() const = 0;
+    // for holding on to the solid model after the group updated it
+    virtual std::shared_ptr<const SolidModel> get_solid_model_shared() const = 0;
     virtual void update_solid_model(const Document &doc) = 0;
     enum class Operation { UNION, DIFFERENCE, INTERSECTION };
     virtual Operation get_operation() const = 0;
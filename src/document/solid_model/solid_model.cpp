@@ -19,10 +19,11 @@ const IGroupSolidModel *SolidModel::get_last_solid_model_group(const Document &d
         if (include_group == IncludeGroup::NO && gr->m_uuid == group.m_uuid)
             break;
         if (auto gr_solid = dynamic_cast<const IGroupSolidModel *>(gr)) {
+            // check the body first, solid models of other bodies may be in the process of getting updated
+            auto body = &gr->find_body(doc).body;
+            if (body != this_body)
+                continue;
             if (auto solid_model = dynamic_cast<const SolidModelOcc *>(gr_solid->get_solid_model())) {
-                auto body = &gr->find_body(doc).body;
-                if (body != this_body)
-                    continue;
                 if (!solid_model->m_shape_acc.IsNull())
                     last_solid_model_group = gr_solid;
             }
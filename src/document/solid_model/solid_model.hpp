@@ -4,6 +4,7 @@
 #include <filesystem>
 #include <vector>
 #include <map>
+#include <span>
 #include <glm/glm.hpp>
 #include "document/group/all_groups_fwd.hpp"
 
@@ -15,10 +16,35 @@ class Group;
 class IGroupSolidModel;
 class STEPExporter;
 
+// Discretized edges of a solid model, the points of all edges are stored back
+// to back so that they can be handed to the canvas as is
+class SolidModelEdges {
+public:
+    struct Edge {
+        // as enumerated by TopExp_Explorer, local operations refer to edges by it
+        unsigned int index;
+        size_t offset;
+        size_t size;
+    };
+    std::vector<Edge> m_edges;
+    std::vector<glm::vec3> m_points;
+
+    std::span<const glm::vec3> get_path(const Edge &edge) const
+    {
+        return {m_points.data() + edge.offset, edge.size};
+    }
+
+    void clear()
+    {
+        m_edges.clear();
+        m_points.clear();
+    }
+};
+
 class SolidModel {
 public:
     face::Faces m_faces;
-    std::map<unsigned int, std::vector<glm::dvec3>> m_edges;
+    SolidModelEdges m_edges;
 
     static std::shared_ptr<const SolidModel> create(const Document &doc, GroupExtrude &group);
     static std::shared_ptr<const SolidModel> create(const Document &doc, GroupFillet &group);
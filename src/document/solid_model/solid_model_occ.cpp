@@ -5,6 +5,7 @@
 #include "document/group/igroup_solid_model.hpp"
 #include "util/fs_util.hpp"
 #include "util/step_exporter.hpp"
+#include "util/face_mesh.hpp"
 
 #include <Standard_Version.hxx>
 
@@ -24,12 +25,16 @@
 #include <BRepTools_WireExplorer.hxx>
 #include <ShapeAnalysis_Edge.hxx>
 #include <BRepAdaptor_Curve.hxx>
+#include <OSD_Parallel.hxx>
+#include <TopTools_IndexedMapOfShape.hxx>
 
 #include <TDF_ChildIterator.hxx>
 #include <TDF_LabelSequence.hxx>
 #include <Poly.hxx>
 #include <glm/glm.hpp>
 #include <map>
+#include <algorithm>
+#include <optional>
 #include <glm/gtc/matrix_transform.hpp>
 #include <glm/gtc/type_ptr.hpp>
 #include <glm/gtx/rotate_vector.hpp>
@@ -51,9 +56,12 @@
 
 namespace dune3d {
 
+#define USER_PREC (0.14)
+#define USER_ANGLE (0.52359878)
+
 class Triangulator {
 public:
-    Triangulator(const TopoDS_Shape &shape, const Color &color, face::Faces &faces);
+    Triangulator(SolidModelOcc &model, const SolidModelOcc *last);
 
 
 private:
@@ -63,24 +71,63 @@ private:
     bool processShell(const TopoDS_Shape &shape, const glm::dmat4 &mat = glm::dmat4(1));
     bool processFace(const TopoDS_Face &face, const glm::dmat4 &mat = glm::dmat4(1));
 
+    bool reuse_face(const SolidModelOcc::FaceKey &key, const Handle(TopoDS_TShape) & tshape);
+    void mesh_faces();
+
+    SolidModelOcc &m_model;
+    const SolidModelOcc *m_last;
     face::Faces &m_faces;
     face::Color m_color;
+
+    // one for each item in m_faces
+    struct FaceInfo {
+        SolidModelOcc::FaceKey key;
+        Handle(TopoDS_TShape) tshape;
+        std::optional<size_t> to_mesh; // index into m_faces_to_mesh unless reused
+    };
+    std::vector<FaceInfo> m_face_infos;
+    std::vector<FaceToMesh> m_faces_to_mesh;
 };
 
-Triangulator::Triangulator(const TopoDS_Shape &shape, const Color &color, face::Faces &faces) : m_faces(faces)
+Triangulator::Triangulator(SolidModelOcc &model, const SolidModelOcc *last)
+    : m_model(model), m_last(last), m_faces(model.m_faces)
 {
-    m_color.r = color.r;
-    m_color.b = color.b;
-    m_color.g = color.g;
-    processNode(shape);
+    m_color.r = model.m_color.r;
+    m_color.b = model.m_color.b;
+    m_color.g = model.m_color.g;
+    processNode(model.m_shape_acc);
+    mesh_faces();
 }
 
-#if OCC_VERSION_MAJOR >= 7 && OCC_VERSION_MINOR >= 6
-#define HORIZON_NEW_OCC
-#endif
+bool Triangulator::reuse_face(const SolidModelOcc::FaceKey &key, const Handle(TopoDS_TShape) & tshape)
+{
+    if (!m_last)
+        return false;
+    auto it = m_last->m_face_cache.find(key);
+    if (it == m_last->m_face_cache.end())
+        return false;
 
-#define USER_PREC (0.14)
-#define USER_ANGLE (0.52359878)
+    m_faces.push_back(m_last->m_faces.at(it->second.index));
+    m_faces.back().color = m_color;
+    m_face_infos.push_back({key, tshape, std::nullopt});
+    return true;
+}
+
+void Triangulator::mesh_faces()
+{
+    dune3d::mesh_faces(m_faces_to_mesh, USER_PREC, USER_ANGLE);
+
+    // drop faces that couldn't be meshed and index the remaining ones for the next solid model
+    face::Faces faces;
+    for (size_t i = 0; i < m_face_infos.size(); i++) {
+        const auto &info = m_face_infos.at(i);
+        if (info.to_mesh && !m_faces_to_mesh.at(*info.to_mesh).ok)
+            continue;
+        faces.push_back(std::move(m_faces.at(i)));
+        m_model.m_face_cache.emplace(info.key, SolidModelOcc::CachedFace{info.tshape, faces.size() - 1});
+    }
+    m_faces = std::move(faces);
+}
 
 static glm::dmat4 update_matrix(const gp_Trsf &tr, const glm::dmat4 &mat_in)
 {
@@ -108,91 +155,20 @@ bool Triangulator::processFace(const TopoDS_Face &face, const glm::dmat4 &mat_in
 
     auto mat = update_matrix(face.Location().Transformation(), mat_in);
 
-    TopLoc_Location loc;
-    Standard_Boolean isTessellate(Standard_False);
-    Handle(Poly_Triangulation) triangulation = BRep_Tool::Triangulation(face, loc);
-
-    if (triangulation.IsNull() || triangulation->Deflection() > USER_PREC + Precision::Confusion())
-        isTessellate = Standard_True;
-
-    if (isTessellate) {
-        BRepMesh_IncrementalMesh IM(face, USER_PREC, Standard_False, USER_ANGLE);
-        triangulation = BRep_Tool::Triangulation(face, loc);
-    }
-
-    if (triangulation.IsNull() == Standard_True)
-        return false;
-
-    Poly::ComputeNormals(triangulation);
-
-#ifndef HORIZON_NEW_OCC
-    const TColgp_Array1OfPnt &arrPolyNodes = triangulation->Nodes();
-    const Poly_Array1OfTriangle &arrTriangles = triangulation->Triangles();
-    const TShort_Array1OfShortReal &arrNormals = triangulation->Normals();
-#endif
-
+    SolidModelOcc::FaceKey key;
+    std::get<0>(key) = face.TShape().get();
+    std::get<1>(key) = face.Orientation();
+    auto &placement = std::get<2>(key);
+    std::copy_n(glm::value_ptr(mat), placement.size(), placement.begin());
+    if (reuse_face(key, face.TShape()))
+        return true;
 
+    // meshed once all faces have been collected
     m_faces.emplace_back();
     auto &face_out = m_faces.back();
     face_out.color = m_color;
-    face_out.vertices.reserve(triangulation->NbNodes());
-
-    std::map<face::Vertex, std::vector<size_t>> pts_map;
-    for (int i = 1; i <= triangulation->NbNodes(); i++) {
-#ifdef HORIZON_NEW_OCC
-        gp_XYZ v(triangulation->Node(i).Coord());
-#else
-        gp_XYZ v(arrPolyNodes(i).Coord());
-#endif
-        const glm::vec4 vg(v.X(), v.Y(), v.Z(), 1);
-        const auto vt = mat * vg;
-        const face::Vertex vertex(vt.x, vt.y, vt.z);
-        pts_map[vertex].push_back(i - 1);
-        face_out.vertices.push_back(vertex);
-    }
-
-    face_out.normals.reserve(triangulation->NbNodes());
-    for (int i = 1; i <= triangulation->NbNodes(); i++) {
-#ifdef HORIZON_NEW_OCC
-        const auto n = triangulation->Normal(i);
-        glm::vec4 vg(n.X(), n.Y(), n.Z(), 0);
-#else
-        auto offset = (i - 1) * 3 + 1;
-        auto x = arrNormals(offset + 0);
-        auto y = arrNormals(offset + 1);
-        auto z = arrNormals(offset + 2);
-        glm::vec4 vg(x, y, z, 0);
-#endif
-        auto vt = mat * vg;
-        vt /= vt.length();
-        face_out.normals.emplace_back(vt.x, vt.y, vt.z);
-    }
-
-    // average normals at coincident vertices
-    for (const auto &[k, v] : pts_map) {
-        if (v.size() > 1) {
-            face::Vertex n_acc(0, 0, 0);
-            for (const auto idx : v) {
-                n_acc += face_out.normals.at(idx);
-            }
-            n_acc /= v.size();
-            for (const auto idx : v) {
-                face_out.normals.at(idx) = n_acc;
-            }
-        }
-    }
-
-    face_out.triangle_indices.reserve(triangulation->NbTriangles());
-    for (int i = 1; i <= triangulation->NbTriangles(); i++) {
-        int a, b, c;
-#ifdef HORIZON_NEW_OCC
-        triangulation->Triangle(i).Get(a, b, c);
-#else
-        arrTriangles(i).Get(a, b, c);
-#endif
-        face_out.triangle_indices.emplace_back(a - 1, b - 1, c - 1);
-        // std::cout << "tr " << a - 1 << " " << b - 1 << " " << c - 1 << std::endl;
-    }
+    m_face_infos.push_back({key, face.TShape(), m_faces_to_mesh.size()});
+    m_faces_to_mesh.push_back({face, mat, &face_out});
 
     return true;
 }
@@ -305,10 +281,11 @@ bool Triangulator::processNode(const TopoDS_Shape &shape)
 }
 
 
-void SolidModelOcc::triangulate()
+void SolidModelOcc::triangulate(const SolidModelOcc *last)
 {
     m_faces.clear();
-    Triangulator tri{m_shape_acc, m_color, m_faces};
+    m_face_cache.clear();
+    Triangulator tri{*this, last};
 }
 
 inline double defaultAngularDeflection(double linearTolerance)
@@ -349,39 +326,40 @@ void SolidModelOcc::add_to_step_exporter(STEPExporter &exporter, const char *nam
 void SolidModelOcc::find_edges()
 {
     m_edges.clear();
-    TopExp_Explorer topex(m_shape_acc, TopAbs_EDGE);
-    std::list<TopoDS_Shape> edges;
+
+    // edge indices count every occurrence of an edge, but each one only gets
+    // discretized the first time it's encountered
+    TopTools_IndexedMapOfShape edge_map;
+    std::vector<unsigned int> edge_indices;
     unsigned int edge_idx = 0;
-    while (topex.More()) {
-        auto edge = TopoDS::Edge(topex.Current());
-        bool skip = false;
-        for (const auto &other : edges) {
-            if (other.IsSame(topex.Current())) {
-                skip = true;
-                break;
-            }
-        }
-        if (skip) {
-            topex.Next();
-            edge_idx++;
-            continue;
-        }
-        edges.push_back(edge);
-        {
-            auto curve = BRepAdaptor_Curve(edge);
-            GCPnts_TangentialDeflection discretizer(curve, M_PI / 16, 1e3);
-            auto &e = m_edges[edge_idx];
-            if (discretizer.NbPoints() > 0) {
-                int nbPoints = discretizer.NbPoints();
-                for (int i = 1; i <= nbPoints; i++) {
-                    const gp_Pnt pnt = discretizer.Value(i);
-                    e.emplace_back(pnt.X(), pnt.Y(), pnt.Z());
-                }
-            }
-        }
-        topex.Next();
+    for (TopExp_Explorer topex(m_shape_acc, TopAbs_EDGE); topex.More(); topex.Next()) {
+        const auto n_before = edge_map.Extent();
+        if (edge_map.Add(topex.Current()) > n_before)
+            edge_indices.push_back(edge_idx);
         edge_idx++;
     }
+
+    std::vector<std::vector<glm::vec3>> paths(edge_indices.size());
+    OSD_Parallel::For(0, static_cast<int>(paths.size()), [&edge_map, &paths](int i) {
+        auto curve = BRepAdaptor_Curve(TopoDS::Edge(edge_map.FindKey(i + 1)));
+        GCPnts_TangentialDeflection discretizer(curve, M_PI / 16, 1e3);
+        auto &path = paths.at(i);
+        for (int j = 1; j <= discretizer.NbPoints(); j++) {
+            const gp_Pnt pnt = discretizer.Value(j);
+            path.emplace_back(pnt.X(), pnt.Y(), pnt.Z());
+        }
+    });
+
+    size_t n_points = 0;
+    for (const auto &path : paths)
+        n_points += path.size();
+    m_edges.m_edges.reserve(paths.size());
+    m_edges.m_points.reserve(n_points);
+    for (size_t i = 0; i < paths.size(); i++) {
+        const auto &path = paths.at(i);
+        m_edges.m_edges.push_back({edge_indices.at(i), m_edges.m_points.size(), path.size()});
+        m_edges.m_points.insert(m_edges.m_points.end(), path.begin(), path.end());
+    }
 }
 
 TopoDS_Shape SolidModelOcc::calc(IGroupSolidModel::Operation op, TopoDS_Shape argument, TopoDS_Shape tool)
@@ -440,7 +418,7 @@ void SolidModelOcc::finish(const Document &doc, const Group &group)
         m_color = Preferences::get().canvas.appearance.get_color(ColorP::SOLID_MODEL);
     }
 
-    triangulate();
+    triangulate(dynamic_cast<const SolidModelOcc *>(get_last_solid_model(doc, group)));
     find_edges();
 }
 
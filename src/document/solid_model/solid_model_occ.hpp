@@ -2,6 +2,10 @@
 #include "document/group/igroup_solid_model.hpp"
 #include "util/color.hpp"
 #include <TopoDS.hxx>
+#include <TopoDS_TShape.hxx>
+#include <array>
+#include <map>
+#include <tuple>
 
 namespace dune3d {
 
@@ -21,11 +25,23 @@ public:
     static TopoDS_Shape calc(IGroupSolidModel::Operation op, TopoDS_Shape argument, TopoDS_Shape tool);
 
 private:
+    friend class Triangulator;
+
     void update_acc(IGroupSolidModel::Operation op, const TopoDS_Shape &last);
     void update_acc(IGroupSolidModel::Operation op, const SolidModelOcc *last);
 
-    void triangulate();
+    void triangulate(const SolidModelOcc *last);
     void find_edges();
+
+    // Index into m_faces by face, its orientation and its placement, so that
+    // the next solid model can reuse the meshes of the faces it inherits from
+    // this one. A reversed face has the opposite winding and normals.
+    using FaceKey = std::tuple<const TopoDS_TShape *, TopAbs_Orientation, std::array<double, 16>>;
+    struct CachedFace {
+        Handle(TopoDS_TShape) tshape; // keeps the key's pointer from getting reused
+        size_t index;
+    };
+    std::map<FaceKey, CachedFace> m_face_cache;
 };
 
 } // namespace dune3d
@@ -8,6 +8,12 @@
 #include <BRepBuilderAPI_Transform.hxx>
 
 #include <BRepAlgoAPI_Fuse.hxx>
+#include <BRepBndLib.hxx>
+#include <BRep_Builder.hxx>
+#include <Bnd_Box.hxx>
+#include <Precision.hxx>
+#include <TopoDS_Compound.hxx>
+#include <TopTools_ListOfShape.hxx>
 
 #include <gp_Ax2.hxx>
 
@@ -16,6 +22,57 @@
 
 namespace dune3d {
 
+// instances whose bounding boxes don't overlap can't intersect, so there's nothing to fuse
+static bool instances_disjoint(const std::vector<TopoDS_Shape> &instances)
+{
+    std::vector<Bnd_Box> boxes;
+    boxes.reserve(instances.size());
+    for (const auto &sh : instances) {
+        Bnd_Box box;
+        BRepBndLib::Add(sh, box);
+        box.Enlarge(Precision::Confusion());
+        boxes.push_back(box);
+    }
+    for (size_t i = 0; i < boxes.size(); i++) {
+        for (size_t j = i + 1; j < boxes.size(); j++) {
+            if (!boxes.at(i).IsOut(boxes.at(j)))
+                return false;
+        }
+    }
+    return true;
+}
+
+static TopoDS_Shape fuse_instances(const std::vector<TopoDS_Shape> &instances)
+{
+    if (instances.size() == 1)
+        return instances.front();
+
+    if (instances_disjoint(instances)) {
+        TopoDS_Compound compound;
+        BRep_Builder builder;
+        builder.MakeCompound(compound);
+        for (const auto &sh : instances)
+            builder.Add(compound, sh);
+        return compound;
+    }
+
+    // fusing all instances in one operation rather than one after another
+    // keeps the operation from getting more expensive with each instance
+    TopTools_ListOfShape arguments;
+    TopTools_ListOfShape tools;
+    arguments.Append(instances.front());
+    for (size_t i = 1; i < instances.size(); i++)
+        tools.Append(instances.at(i));
+
+    BRepAlgoAPI_Fuse fuse;
+    fuse.SetArguments(arguments);
+    fuse.SetTools(tools);
+    fuse.SetRunParallel(true);
+    fuse.Build();
+    if (!fuse.IsDone())
+        return {};
+    return fuse.Shape();
+}
 
 static std::shared_ptr<const SolidModel> create_replicate(const Document &doc, GroupReplicate &group,
                                                           std::function<gp_Trsf(unsigned int)> make_trsf)
@@ -71,13 +128,21 @@ static std::shared_ptr<const SolidModel> create_replicate(const Document &doc, G
     }
 
 
+    std::vector<TopoDS_Shape> instances;
+    instances.reserve(group.get_count());
     for (unsigned int instance = 0; instance < group.get_count(); instance++) {
         auto trsf = make_trsf(instance);
-        TopoDS_Shape sh = BRepBuilderAPI_Transform(shape, trsf);
-        if (mod->m_shape.IsNull())
-            mod->m_shape = sh;
-        else
-            mod->m_shape = BRepAlgoAPI_Fuse(mod->m_shape, sh);
+        instances.push_back(BRepBuilderAPI_Transform(shape, trsf));
+    }
+    if (instances.empty()) {
+        group.m_array_messages.emplace_back(GroupStatusMessage::Status::ERR, "no instances");
+        return nullptr;
+    }
+
+    mod->m_shape = fuse_instances(instances);
+    if (mod->m_shape.IsNull()) {
+        group.m_array_messages.emplace_back(GroupStatusMessage::Status::ERR, "couldn't fuse instances");
+        return nullptr;
     }
 
     if (!mod->update_acc_finish(doc, group)) {
@@ -21,12 +21,18 @@ std::shared_ptr<const SolidModel> SolidModel::create(const Document &doc, GroupS
     auto mod = std::make_shared<SolidModelOcc>();
 
     TopoDS_Shape fused;
+    group.m_pending_step_imports.clear();
     for (const auto &[uu, en] : doc.m_entities) {
         if (en->m_group != group.m_uuid)
             continue;
         if (const auto step = dynamic_cast<const EntitySTEP *>(en.get())) {
             if (!step->m_include_in_solid_model)
                 continue;
+            if (!step->m_imported->ready) {
+                // see Document::set_step_solid_models_pending
+                group.m_pending_step_imports.push_back(step->m_imported);
+                continue;
+            }
 
             if (auto shapes = step->m_imported->get_shapes()) {
                 gp_Trsf trsf;
@@ -18,6 +18,8 @@
 #include <NCollection_Array1.hxx>
 #include <Geom_BezierCurve.hxx>
 #include <gp_Circ.hxx>
+#include <algorithm>
+#include <cmath>
 
 namespace dune3d::solid_model_util {
 
@@ -92,7 +94,48 @@ static glm::dvec2 euler(double r, double phi)
     return {r * cos(phi), r * sin(phi)};
 }
 
-static Clipper2Lib::PathD path_to_clipper(const Path &path, unsigned int path_index)
+// fewer than this and a curve wouldn't have vertices in both halves, see VertexInfo::make_z
+static constexpr unsigned int s_min_segments = 4;
+static constexpr unsigned int s_max_segments = 4096;
+
+static unsigned int clamp_segments(double segments)
+{
+    if (!std::isfinite(segments))
+        return s_min_segments;
+    return std::clamp(static_cast<unsigned int>(std::min(std::ceil(segments), (double)s_max_segments)),
+                      s_min_segments, s_max_segments);
+}
+
+// segments needed so that the chords of an arc don't deviate from it by more than the tolerance
+static unsigned int get_arc_segments(double radius, double dphi, double tolerance)
+{
+    if (!(radius > tolerance))
+        return s_min_segments;
+    const auto max_step = 2 * std::acos(1 - tolerance / radius);
+    return clamp_segments(std::abs(dphi) / max_step);
+}
+
+// arcs may be scaled non-uniformly by a cluster, use the larger axis of the resulting ellipse
+static double get_transformed_radius(const Edge &edge, const glm::dvec2 &center, double radius)
+{
+    const auto c = edge.transform(center);
+    return std::max(glm::length(edge.transform(center + glm::dvec2(radius, 0)) - c),
+                    glm::length(edge.transform(center + glm::dvec2(0, radius)) - c));
+}
+
+// Sampling a cubic Bézier at n uniform steps deviates from it by at most max|B''| / (8 n^2),
+// with max|B''| <= 6 max(|p0 - 2 c0 + c1|, |c0 - 2 c1 + p1|).
+static unsigned int get_bezier_segments(const Edge &edge, const EntityBezier2D &bezier, double tolerance)
+{
+    const auto p0 = edge.transform(bezier.m_p1);
+    const auto c0 = edge.transform(bezier.m_c1);
+    const auto c1 = edge.transform(bezier.m_c2);
+    const auto p1 = edge.transform(bezier.m_p2);
+    const auto dd = std::max(glm::length(p0 - 2. * c0 + c1), glm::length(c0 - 2. * c1 + p1));
+    return clamp_segments(std::sqrt(6 * dd / (8 * tolerance)));
+}
+
+static Clipper2Lib::PathD path_to_clipper(const Path &path, unsigned int path_index, double tolerance)
 {
     Clipper2Lib::PathD cpath;
     cpath.reserve(path.size());
@@ -100,15 +143,14 @@ static Clipper2Lib::PathD path_to_clipper(const Path &path, unsigned int path_in
         auto &[node, edge] = path.at(iv);
         if (auto circle = dynamic_cast<const EntityCircle2D *>(&edge.entity)) {
             {
-                const unsigned int segments = 64;
+                const auto radius = get_transformed_radius(edge, circle->m_center, circle->m_radius);
+                const unsigned int segments = get_arc_segments(radius, 2 * M_PI, tolerance);
 
-                float dphi = 2 * M_PI;
-                dphi /= segments;
-                float a = 0;
+                const double dphi = 2 * M_PI / segments;
+                cpath.reserve(segments);
                 for (unsigned int i = 0; i < segments; i++) {
-                    const auto p0 = edge.transform(circle->m_center + euler(circle->m_radius, a));
+                    const auto p0 = edge.transform(circle->m_center + euler(circle->m_radius, i * dphi));
                     cpath.emplace_back(p0.x, p0.y, VertexInfo::make_z(path_index, iv, i, segments));
-                    a += dphi;
                 }
             }
             break;
@@ -123,26 +165,26 @@ static Clipper2Lib::PathD path_to_clipper(const Path &path, unsigned int path_in
             const auto radius0 = glm::length(arc->m_center - arc->m_from);
             const auto a0 = c2pi(angle(pc - arc->m_center));
             const auto a1 = c2pi(angle(Paths::get_pt(edge.entity, pt == 1 ? 2 : 1, nullptr) - arc->m_center));
-            const unsigned int segments = 64;
 
-            float dphi = c2pi(a1 - a0);
+            double dphi = c2pi(a1 - a0);
             if (pt == 2) {
                 dphi = c2pim(a1 - a0);
             }
             if (std::abs(dphi) < 1e-2)
                 dphi = 2 * M_PI;
 
+            const auto radius = get_transformed_radius(edge, arc->m_center, radius0);
+            const unsigned int segments = get_arc_segments(radius, dphi, tolerance);
+
             dphi /= segments;
-            float a = a0;
             for (unsigned int i = 0; i < segments; i++) {
-                const auto p0 = edge.transform(arc->m_center + euler(radius0, a));
+                const auto p0 = edge.transform(arc->m_center + euler(radius0, a0 + i * dphi));
                 cpath.emplace_back(p0.x, p0.y, VertexInfo::make_z(path_index, iv, i, segments));
-                a += dphi;
             }
         }
         else if (auto bezier = dynamic_cast<const EntityBezier2D *>(&edge.entity)) {
             const bool forward = pt == 1;
-            const unsigned int segments = 64;
+            const unsigned int segments = get_bezier_segments(edge, *bezier, tolerance);
 
             for (unsigned int i = 0; i < segments; i++) {
                 auto t = (double)i / segments;
@@ -354,7 +396,8 @@ TopoDS_Wire FaceBuilder::path_to_wire(const Clipper2Lib::PathD &path, bool hole,
 }
 
 FaceBuilder FaceBuilder::from_document(const Document &doc, const UUID &wrkpl_uu, const UUID &source_group_uu,
-                                       Transform fn_transform, Transform fn_transform_normal)
+                                       Transform fn_transform, Transform fn_transform_normal,
+                                       double curve_tolerance)
 {
     auto paths = Paths::from_document(doc, wrkpl_uu, source_group_uu);
 
@@ -365,7 +408,7 @@ FaceBuilder FaceBuilder::from_document(const Document &doc, const UUID &wrkpl_uu
         unsigned int path_index = 0;
         for (auto &path : paths.paths) {
             if (path_is_valid(path))
-                cpaths.emplace_back(path_to_clipper(path, path_index++));
+                cpaths.emplace_back(path_to_clipper(path, path_index++, curve_tolerance));
         }
     }
     Clipper2Lib::PolyTreeD poly_tree;
@@ -399,11 +442,11 @@ FaceBuilder FaceBuilder::from_document(const Document &doc, const UUID &wrkpl_uu
 }
 
 FaceBuilder FaceBuilder::from_document(const Document &doc, const UUID &wrkpl_uu, const UUID &source_group_uu,
-                                       const glm::dvec3 &offset)
+                                       const glm::dvec3 &offset, double curve_tolerance)
 {
     return from_document(
             doc, wrkpl_uu, source_group_uu, [offset](const glm::dvec3 &p) { return p + offset; },
-            [](const glm::dvec3 &p) { return p; });
+            [](const glm::dvec3 &p) { return p; }, curve_tolerance);
 }
 
 } // namespace dune3d::solid_model_util
@@ -24,10 +24,17 @@ using namespace paths;
 class FaceBuilder {
 public:
     using Transform = std::function<glm::dvec3(const glm::dvec3 &)>;
+
+    // maximum distance between a curve and the polygon it's flattened into for clipping,
+    // the faces themselves are built from the exact curves
+    static constexpr double s_default_curve_tolerance = 1e-2;
+
     static FaceBuilder from_document(const Document &doc, const UUID &wrkpl_uu, const UUID &source_group_uu,
-                                     const glm::dvec3 &offset);
+                                     const glm::dvec3 &offset,
+                                     double curve_tolerance = s_default_curve_tolerance);
     static FaceBuilder from_document(const Document &doc, const UUID &wrkpl_uu, const UUID &source_group_uu,
-                                     Transform fn_transform, Transform fn_transform_normal);
+                                     Transform fn_transform, Transform fn_transform_normal,
+                                     double curve_tolerance = s_default_curve_tolerance);
 
     const TopoDS_Compound &get_faces() const;
     const auto &get_wires() const
@@ -10,6 +10,8 @@
 #include "widgets/log_view.hpp"
 #include "logger/log_util.hpp"
 #include "editor/buffer.hpp"
+#include "import_step/step_import_manager.hpp"
+#include "util/task_graph.hpp"
 #include <iostream>
 #include <iomanip>
 
@@ -122,6 +124,8 @@ void Dune3DApplication::on_startup()
 void Dune3DApplication::on_shutdown()
 {
     m_user_config.save(get_user_config_filename());
+    STEPImportManager::get().shutdown();
+    TaskGraph::shutdown_threads();
     Gtk::Application::on_shutdown();
 }
 
@@ -28,6 +28,7 @@
 #include "logger/log_util.hpp"
 #include "nlohmann/json.hpp"
 #include "buffer.hpp"
+#include "import_step/step_import_manager.hpp"
 #include <iostream>
 
 namespace dune3d {
@@ -52,7 +53,10 @@ Editor::Editor(Dune3DAppWindow &win, Preferences &prefs)
     m_drag_tool = ToolID::NONE;
 }
 
-Editor::~Editor() = default;
+Editor::~Editor()
+{
+    STEPImportManager::get().set_update_handler(nullptr);
+}
 
 void Editor::init()
 {
@@ -70,6 +74,12 @@ void Editor::init()
     });
     get_canvas().signal_selection_changed().connect([this] { update_action_sensitivity(); });
 
+    m_step_import_dispatcher.connect([this] {
+        m_core.update_step_solid_models();
+        canvas_update_keep_selection();
+    });
+    STEPImportManager::get().set_update_handler([this] { m_step_import_dispatcher.emit(); });
+
     m_win.signal_close_request().connect(
             [this] {
                 if (!m_core.get_needs_save_any())
@@ -457,7 +467,7 @@ void Editor::init_canvas()
             "remove_constraint", Glib::Variant<std::string>::variant_type(), [this](Glib::VariantBase const &value) {
                 UUID uu = Glib::VariantBase::cast_dynamic<Glib::Variant<std::string>>(value).get();
                 auto &doc = m_core.get_current_document();
-                doc.m_constraints.erase(uu);
+                doc.erase_constraint(uu);
                 doc.set_group_solve_pending(m_core.get_current_group());
                 m_core.set_needs_save();
                 m_core.rebuild("remove constraint");
@@ -1110,6 +1120,8 @@ void Editor::update_group_editor()
 void Editor::handle_commit_from_editor(CommitMode mode)
 {
     if (mode == CommitMode::DELAYED) {
+        // don't let a background rebuild overwrite the edit we're about to commit
+        m_core.cancel_rebuild();
         m_core.get_current_document().update_pending(m_core.get_current_group());
         m_delayed_commit_connection.disconnect(); // stop old timer
         m_delayed_commit_connection = Glib::signal_timeout().connect(
@@ -1224,6 +1236,9 @@ void Editor::apply_preferences()
     get_canvas().set_zoom_to_cursor(m_preferences.canvas.zoom_to_cursor);
     get_canvas().set_rotation_scheme(m_preferences.canvas.rotation_scheme);
 
+    Document::set_update_mode(m_preferences.editor.parallel_rebuild ? Document::UpdateMode::PARALLEL
+                                                                    : Document::UpdateMode::SERIAL);
+
     m_win.tool_bar_set_vertical(m_preferences.tool_bar.vertical_layout);
     update_action_bar_visibility();
     update_error_overlay();
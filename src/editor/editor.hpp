@@ -232,6 +232,8 @@ private:
     GroupEditor *m_group_editor = nullptr;
     void update_group_editor();
     sigc::connection m_delayed_commit_connection;
+    // STEP imports running in the background report progress through this
+    Glib::Dispatcher m_step_import_dispatcher;
     void commit_from_editor();
     void handle_commit_from_editor(CommitMode mode);
 
@@ -212,6 +212,7 @@ void Editor::init_actions()
     m_win.get_workplane_checkbutton().signal_toggled().connect([this] { update_action_bar_buttons_sensitivity(); });
 
     connect_action(ActionID::SELECT_PATH, [this](auto &a) {
+        m_core.finish_rebuild();
         auto &doc = m_core.get_current_document();
 
         auto enp = point_from_selection(doc, get_canvas().get_selection());
@@ -878,13 +879,13 @@ void Editor::on_explode_cluster(const ActionConnection &conn)
         auto en_cloned = en->clone();
         en_cloned->m_group = group.m_uuid;
         dynamic_cast<IEntityInWorkplaneSet &>(*en_cloned).set_workplane(cluster.m_wrkpl);
-        doc.m_entities.emplace(uu, std::move(en_cloned));
+        doc.insert_entity(std::move(en_cloned));
     }
     for (const auto &[uu, co] : cluster.m_content->m_constraints) {
         auto co_cloned = co->clone();
         co_cloned->m_group = group.m_uuid;
         co_cloned->replace_entity(content_wrkpl, cluster.m_wrkpl);
-        doc.m_constraints.emplace(uu, std::move(co_cloned));
+        doc.insert_constraint(std::move(co_cloned));
     }
     finish_add_group(&group);
 }
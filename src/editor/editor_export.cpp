@@ -163,6 +163,7 @@ void Editor::on_export_solid_model(const ActionConnection &conn)
             // open_file_view(file);
             //  Notice that this is a std::string, not a Glib::ustring.
             const auto path = path_from_string(append_suffix_if_required(file->get_path(), suffix));
+            m_core.finish_rebuild();
             auto &doc_info = m_core.get_current_idocument_info();
             if (action == ActionID::EXPORT_ALL_SOLID_MODELS_STEP) {
                 export_all_step(doc_info, path);
@@ -231,6 +232,7 @@ void Editor::on_export_paths(const ActionConnection &conn)
             // open_file_view(file);
             //  Notice that this is a std::string, not a Glib::ustring.
             const auto path = path_from_string(append_suffix_if_required(file->get_path(), suffix));
+            m_core.finish_rebuild();
 
             auto group_filter = [this, action](const Group &group) {
                 if (m_core.get_current_group() == group.m_uuid)
@@ -289,6 +291,7 @@ void Editor::on_export_projection(const ActionConnection &conn)
             // open_file_view(file);
             //  Notice that this is a std::string, not a Glib::ustring.
             const auto path = path_from_string(append_suffix_if_required(file->get_path(), ".svg"));
+            m_core.finish_rebuild();
 
             auto sel = get_canvas().get_selection();
             glm::dvec3 origin = get_canvas().get_center();
@@ -69,6 +69,12 @@ void Editor::init_workspace_browser()
             m_workspace_browser->update_documents(m_workspace_views.at(m_current_workspace_view).m_documents);
         });
     });
+    m_core.signal_rebuild_state_changed().connect([this] {
+        if (!m_current_workspace_view)
+            return;
+        CanvasUpdater canvas_updater{*this};
+        m_workspace_browser->update_current_group(get_current_document_views());
+    });
 
     m_win.get_left_bar().set_start_child(*m_workspace_browser);
 }
@@ -586,7 +586,10 @@ void SelectionEditor::set_selection(const std::set<SelectableRef> &sel)
             m_title->set_tooltip_text((std::string)wrkpl->entity);
             auto ed = Gtk::make_managed<WorkplaneEditor>(m_core.get_current_document(), wrkpl->entity);
             m_editor = ed;
-            ed->signal_changed().connect([this](auto mode) { m_signal_changed.emit(mode); });
+            ed->signal_changed().connect([this, uu = wrkpl->entity](auto mode) {
+                m_core.get_current_document().set_item_changed(uu);
+                m_signal_changed.emit(mode);
+            });
         }
         else if (auto step = point_from_selection(m_core.get_current_document(), sel, Entity::Type::STEP)) {
             m_title->set_label("STEP");
@@ -596,7 +599,8 @@ void SelectionEditor::set_selection(const std::set<SelectableRef> &sel)
                                                     m_core.get_current_document().get_entity<EntitySTEP>(step->entity));
             m_editor = ed;
             auto group = m_core.get_current_document().get_entity(step->entity).m_group;
-            ed->signal_changed().connect([this, group](auto mode) {
+            ed->signal_changed().connect([this, group, uu = step->entity](auto mode) {
+                m_core.get_current_document().set_item_changed(uu);
                 m_core.get_current_document().set_group_update_solid_model_pending(group);
                 m_signal_changed.emit(mode);
             });
@@ -613,7 +617,10 @@ void SelectionEditor::set_selection(const std::set<SelectableRef> &sel)
                     m_core.get_current_document_directory(),
                     m_core.get_current_document().get_entity<EntityDocument>(doc->entity));
             m_editor = ed;
-            ed->signal_changed().connect([this](auto mode) { m_signal_changed.emit(mode); });
+            ed->signal_changed().connect([this, uu = doc->entity](auto mode) {
+                m_core.get_current_document().set_item_changed(uu);
+                m_signal_changed.emit(mode);
+            });
         }
         else if (auto cluster = point_from_selection(m_core.get_current_document(), sel, Entity::Type::CLUSTER)) {
             m_title->set_label("Cluster");
@@ -621,7 +628,8 @@ void SelectionEditor::set_selection(const std::set<SelectableRef> &sel)
             auto ed = Gtk::make_managed<ClusterEditor>(m_core.get_current_document(), cluster->entity);
             m_editor = ed;
             auto group = m_core.get_current_document().get_entity(cluster->entity).m_group;
-            ed->signal_changed().connect([this, group](auto mode) {
+            ed->signal_changed().connect([this, group, uu = cluster->entity](auto mode) {
+                m_core.get_current_document().set_item_changed(uu);
                 m_core.get_current_document().set_group_solve_pending(group);
                 m_signal_changed.emit(mode);
             });
@@ -632,7 +640,8 @@ void SelectionEditor::set_selection(const std::set<SelectableRef> &sel)
             auto ed = Gtk::make_managed<PictureEditor>(m_core.get_current_document(), picture->entity);
             m_editor = ed;
             auto group = m_core.get_current_document().get_entity(picture->entity).m_group;
-            ed->signal_changed().connect([this, group](auto mode) {
+            ed->signal_changed().connect([this, group, uu = picture->entity](auto mode) {
+                m_core.get_current_document().set_item_changed(uu);
                 m_core.get_current_document().set_group_solve_pending(group);
                 m_signal_changed.emit(mode);
             });
@@ -643,7 +652,8 @@ void SelectionEditor::set_selection(const std::set<SelectableRef> &sel)
             auto ed = Gtk::make_managed<TextEditor>(m_core.get_current_document(), text->entity);
             m_editor = ed;
             auto group = m_core.get_current_document().get_entity(text->entity).m_group;
-            ed->signal_changed().connect([this, group](auto mode) {
+            ed->signal_changed().connect([this, group, uu = text->entity](auto mode) {
+                m_core.get_current_document().set_item_changed(uu);
                 m_core.get_current_document().set_group_solve_pending(group);
                 m_signal_changed.emit(mode);
             });
@@ -262,6 +262,7 @@ void WorkspaceBrowser::update_current_group(const std::map<UUID, DocumentView> &
         it_doc.m_active = is_current_doc;
         update_name(it_doc, doci);
         const auto &doc = doci.get_document();
+        const bool rebuilding = m_core.is_rebuilding(doci.get_uuid());
         const auto &current_group = doc.get_group(doci.get_current_group());
         std::set<UUID> source_groups;
         if (auto group_src = dynamic_cast<const IGroupSourceGroup *>(&current_group))
@@ -303,7 +304,11 @@ void WorkspaceBrowser::update_current_group(const std::map<UUID, DocumentView> &
                     it_group.m_check_sensitive = true;
                     it_group.m_check_active = doc_view.group_is_visible(it_group.m_uuid);
                 }
-                {
+                if (rebuilding && doc.is_group_update_pending(it_group.m_uuid)) {
+                    it_group.m_status = GroupStatusMessage::Status::INFO;
+                    it_group.m_status_message = "Rebuilding…";
+                }
+                else {
                     auto msgs = gr.get_messages();
                     it_group.m_status = GroupStatusMessage::summarize(msgs);
                     Glib::ustring txt;
@@ -5,6 +5,8 @@
 #include <vector>
 #include <tuple>
 #include <filesystem>
+#include <functional>
+#include <memory>
 
 namespace dune3d::STEPImporter {
 using namespace dune3d::face;
@@ -23,6 +25,17 @@ public:
 };
 
 
-Result import(const std::filesystem::path &filename);
+// Callbacks are invoked on the thread running the import
+class ImportProgress {
+public:
+    // once the file has been read, before any faces get meshed
+    std::function<void(const Point &bbox_min, const Point &bbox_max)> on_bbox;
+    // after each face, returning false cancels the import
+    std::function<bool(unsigned int faces_done, unsigned int faces_total)> on_face;
+};
+
+// returns an empty result if the import failed or got cancelled, otherwise
+// the result's shapes are the ones the mesh was made from
+Result import(const std::filesystem::path &filename, const ImportProgress &progress = {});
 std::shared_ptr<const Shapes> import_shapes(const std::filesystem::path &filename);
 } // namespace dune3d::STEPImporter
@@ -2,20 +2,43 @@
 #include "import.hpp"
 #include <filesystem>
 #include <atomic>
+#include <optional>
+#include <mutex>
+#include <utility>
 
 namespace dune3d {
 
 class ImportedSTEP {
 public:
-    ImportedSTEP(const std::filesystem::path &p, const std::string &h) : path(p), hash(h)
+    explicit ImportedSTEP(const std::filesystem::path &p) : path(p)
     {
     }
 
-    std::atomic_bool ready;
+    // hash and result may only be accessed once this is set
+    std::atomic_bool ready = false;
+    std::atomic_bool cancelled = false;
     const std::filesystem::path path;
-    const std::string hash;
+    std::string hash;
     STEPImporter::Result result;
 
+    // nullptr until ready
     const STEPImporter::Shapes *get_shapes() const;
+
+    using BBox = std::pair<STEPImporter::Point, STEPImporter::Point>;
+    // available before the result is ready, for showing a placeholder
+    std::optional<BBox> get_bbox() const;
+    void set_bbox(const BBox &bbox);
+
+    struct Progress {
+        unsigned int faces_done = 0;
+        unsigned int faces_total = 0;
+    };
+    Progress get_progress() const;
+    void set_progress(const Progress &progress);
+
+private:
+    mutable std::mutex m_mutex;
+    std::optional<BBox> m_bbox;
+    Progress m_progress;
 };
 } // namespace dune3d
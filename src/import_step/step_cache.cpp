@@ -0,0 +1,281 @@
+#include "step_cache.hpp"
+#include "shapes.hpp"
+#include "util/fs_util.hpp"
+#include <glibmm.h>
+#include <BinTools.hxx>
+#include <BRep_Builder.hxx>
+#include <Standard_Failure.hxx>
+#include <TopoDS_Compound.hxx>
+#include <TopoDS_Iterator.hxx>
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+#include <type_traits>
+
+namespace dune3d::STEPImporter {
+
+// File layout, all in host byte order:
+//   Header
+//   FaceHeader for each face
+//   vertices of all faces, then normals of all faces (3 floats each)
+//   triangle indices of all faces (3 uint32 each, relative to the face)
+//   points (3 doubles each)
+//   number of points for each edge (uint64), then all edge points (3 doubles each)
+
+namespace {
+
+constexpr char s_magic[8] = {'D', '3', 'S', 'T', 'E', 'P', 'M', 'C'};
+constexpr uint32_t s_version = 1;
+constexpr uint32_t s_byte_order = 0x01020304;
+
+struct Header {
+    char magic[8];
+    uint32_t version;
+    uint32_t byte_order;
+    uint64_t n_faces;
+    uint64_t n_points;
+    uint64_t n_edges;
+};
+
+struct FaceHeader {
+    float r, g, b;
+    uint32_t reserved;
+    uint64_t n_vertices;
+    uint64_t n_triangles;
+};
+
+static_assert(std::is_trivially_copyable_v<Vertex> && sizeof(Vertex) == 3 * sizeof(float));
+static_assert(std::is_trivially_copyable_v<Point> && sizeof(Point) == 3 * sizeof(double));
+
+class Writer {
+public:
+    template <typename T> void write(const T &x)
+    {
+        write_array(&x, 1);
+    }
+
+    template <typename T> void write_array(const T *x, size_t n)
+    {
+        static_assert(std::is_trivially_copyable_v<T>);
+        m_buffer.append(reinterpret_cast<const char *>(x), n * sizeof(T));
+    }
+
+    const std::string &get_buffer() const
+    {
+        return m_buffer;
+    }
+
+private:
+    std::string m_buffer;
+};
+
+class Reader {
+public:
+    Reader(const char *data, size_t size) : m_data(data), m_size(size)
+    {
+    }
+
+    template <typename T> bool read(T &x)
+    {
+        return read_array(&x, 1);
+    }
+
+    template <typename T> bool read_array(T *x, uint64_t n)
+    {
+        static_assert(std::is_trivially_copyable_v<T>);
+        if (n > (m_size - m_pos) / sizeof(T))
+            return false;
+        if (n)
+            memcpy(x, m_data + m_pos, n * sizeof(T));
+        m_pos += n * sizeof(T);
+        return true;
+    }
+
+    // checks the size before allocating, so that a corrupted count can't make us allocate a lot
+    template <typename T> bool read_vector(std::vector<T> &v, uint64_t n)
+    {
+        if (n > (m_size - m_pos) / sizeof(T))
+            return false;
+        v.resize(n);
+        return read_array(v.data(), n);
+    }
+
+    bool at_end() const
+    {
+        return m_pos == m_size;
+    }
+
+private:
+    const char *m_data;
+    const size_t m_size;
+    size_t m_pos = 0;
+};
+
+bool load_from_buffer(Reader &rd, Result &result)
+{
+    Header hdr;
+    if (!rd.read(hdr))
+        return false;
+    if (memcmp(hdr.magic, s_magic, sizeof(s_magic)) || hdr.version != s_version || hdr.byte_order != s_byte_order)
+        return false;
+
+    std::vector<FaceHeader> face_headers;
+    if (!rd.read_vector(face_headers, hdr.n_faces))
+        return false;
+
+    result.faces.resize(face_headers.size());
+    for (size_t i = 0; i < face_headers.size(); i++) {
+        const auto &fh = face_headers.at(i);
+        result.faces.at(i).color = Color(fh.r, fh.g, fh.b);
+        if (!rd.read_vector(result.faces.at(i).vertices, fh.n_vertices))
+            return false;
+    }
+    for (size_t i = 0; i < face_headers.size(); i++) {
+        if (!rd.read_vector(result.faces.at(i).normals, face_headers.at(i).n_vertices))
+            return false;
+    }
+    std::vector<uint32_t> indices;
+    for (size_t i = 0; i < face_headers.size(); i++) {
+        const auto n_triangles = face_headers.at(i).n_triangles;
+        if (n_triangles > std::numeric_limits<uint64_t>::max() / 3 || !rd.read_vector(indices, n_triangles * 3))
+            return false;
+        // a corrupt entry mustn't make the renderer read past the face's vertices
+        const auto n_vertices = face_headers.at(i).n_vertices;
+        if (std::ranges::any_of(indices, [n_vertices](auto idx) { return idx >= n_vertices; }))
+            return false;
+        auto &triangles = result.faces.at(i).triangle_indices;
+        triangles.reserve(n_triangles);
+        for (size_t t = 0; t < n_triangles; t++)
+            triangles.emplace_back(indices[t * 3], indices[t * 3 + 1], indices[t * 3 + 2]);
+    }
+
+    if (!rd.read_vector(result.points, hdr.n_points))
+        return false;
+
+    std::vector<uint64_t> edge_sizes;
+    if (!rd.read_vector(edge_sizes, hdr.n_edges))
+        return false;
+    result.edges.resize(edge_sizes.size());
+    for (size_t i = 0; i < edge_sizes.size(); i++) {
+        if (!rd.read_vector(result.edges.at(i), edge_sizes.at(i)))
+            return false;
+    }
+
+    return rd.at_end();
+}
+
+} // namespace
+
+bool load_cache(const std::filesystem::path &path, Result &result)
+{
+    auto mapped = g_mapped_file_new(path_to_string(path).c_str(), false, NULL);
+    if (!mapped)
+        return false;
+
+    Reader rd{g_mapped_file_get_contents(mapped), g_mapped_file_get_length(mapped)};
+    Result loaded;
+    const bool ok = load_from_buffer(rd, loaded);
+    g_mapped_file_unref(mapped);
+
+    if (!ok)
+        return false;
+    result.faces = std::move(loaded.faces);
+    result.points = std::move(loaded.points);
+    result.edges = std::move(loaded.edges);
+    return true;
+}
+
+void save_cache(const std::filesystem::path &path, const Result &result)
+{
+    Writer wr;
+    Header hdr;
+    memcpy(hdr.magic, s_magic, sizeof(s_magic));
+    hdr.version = s_version;
+    hdr.byte_order = s_byte_order;
+    hdr.n_faces = result.faces.size();
+    hdr.n_points = result.points.size();
+    hdr.n_edges = result.edges.size();
+    wr.write(hdr);
+
+    for (const auto &face : result.faces) {
+        if (face.normals.size() != face.vertices.size())
+            throw std::runtime_error("face has mismatched normals");
+        if (face.vertices.size() > std::numeric_limits<uint32_t>::max())
+            throw std::runtime_error("face has too many vertices");
+        FaceHeader fh;
+        fh.r = face.color.r;
+        fh.g = face.color.g;
+        fh.b = face.color.b;
+        fh.reserved = 0;
+        fh.n_vertices = face.vertices.size();
+        fh.n_triangles = face.triangle_indices.size();
+        wr.write(fh);
+    }
+    for (const auto &face : result.faces)
+        wr.write_array(face.vertices.data(), face.vertices.size());
+    for (const auto &face : result.faces)
+        wr.write_array(face.normals.data(), face.normals.size());
+    std::vector<uint32_t> indices;
+    for (const auto &face : result.faces) {
+        indices.clear();
+        indices.reserve(face.triangle_indices.size() * 3);
+        for (const auto &[a, b, c] : face.triangle_indices) {
+            indices.push_back(a);
+            indices.push_back(b);
+            indices.push_back(c);
+        }
+        wr.write_array(indices.data(), indices.size());
+    }
+
+    wr.write_array(result.points.data(), result.points.size());
+    for (const auto &edge : result.edges)
+        wr.write<uint64_t>(edge.size());
+    for (const auto &edge : result.edges)
+        wr.write_array(edge.data(), edge.size());
+
+    const auto &buf = wr.get_buffer();
+    Glib::file_set_contents(path_to_string(path), buf.data(), buf.size());
+}
+
+std::shared_ptr<const Shapes> load_shapes_cache(const std::filesystem::path &path)
+{
+    if (!std::filesystem::exists(path))
+        return nullptr;
+
+    TopoDS_Shape shape;
+    try {
+        if (!BinTools::Read(shape, path_to_string(path).c_str()))
+            return nullptr;
+    }
+    catch (const Standard_Failure &) {
+        return nullptr;
+    }
+    if (shape.IsNull() || shape.ShapeType() != TopAbs_COMPOUND)
+        return nullptr;
+
+    auto shapes = std::make_shared<Shapes>();
+    for (TopoDS_Iterator it(shape); it.More(); it.Next())
+        shapes->shapes.push_back(it.Value());
+    return shapes;
+}
+
+void save_shapes_cache(const std::filesystem::path &path, const Shapes &shapes)
+{
+    TopoDS_Compound compound;
+    BRep_Builder builder;
+    builder.MakeCompound(compound);
+    for (const auto &shape : shapes.shapes)
+        builder.Add(compound, shape);
+
+    // written next to the final file and then moved there, so that a partial
+    // file never ends up in the cache
+    auto tmp_path = path;
+    tmp_path += ".tmp";
+    if (!BinTools::Write(compound, path_to_string(tmp_path).c_str()))
+        throw std::runtime_error("couldn't write shapes cache");
+    std::filesystem::rename(tmp_path, path);
+}
+
+} // namespace dune3d::STEPImporter
@@ -0,0 +1,18 @@
+#pragma once
+#include "import.hpp"
+#include <filesystem>
+#include <memory>
+
+namespace dune3d::STEPImporter {
+
+// Flat binary cache of an import's mesh. Arrays are stored as they are laid
+// out in memory, so loading one is copying it out of the mapped file.
+bool load_cache(const std::filesystem::path &path, Result &result);
+void save_cache(const std::filesystem::path &path, const Result &result);
+
+// B-rep of an import in OpenCASCADE's binary format, so that getting the
+// shapes doesn't require parsing the STEP file again
+std::shared_ptr<const Shapes> load_shapes_cache(const std::filesystem::path &path);
+void save_shapes_cache(const std::filesystem::path &path, const Shapes &shapes);
+
+} // namespace dune3d::STEPImporter
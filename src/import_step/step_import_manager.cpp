@@ -1,9 +1,13 @@
 #include "step_import_manager.hpp"
 #include "import.hpp"
+#include "step_cache.hpp"
+#include "shapes.hpp"
 #include "nlohmann/json.hpp"
 #include "util/util.hpp"
 #include <glibmm.h>
+#include <glib/gstdio.h>
 #include <giomm.h>
+#include <algorithm>
 #include "util/fs_util.hpp"
 
 namespace dune3d {
@@ -22,15 +26,63 @@ static void create_cache_dir()
         Gio::File::create_for_path(path_to_string(cache_dir))->make_directory_with_parents();
 }
 
+static std::filesystem::path get_cache_path(const std::string &hash)
+{
+    return get_cache_dir() / (hash + ".mesh");
+}
+
+static std::filesystem::path get_shapes_cache_path(const std::string &hash)
+{
+    return get_cache_dir() / (hash + ".brep");
+}
+
 STEPImportManager::STEPImportManager()
 {
     create_cache_dir();
 }
 
+void STEPImportManager::shutdown()
+{
+    {
+        std::lock_guard<std::mutex> guard(m_mutex);
+        for (auto &[path, entry] : m_imported)
+            entry.imported->cancelled = true;
+        m_done_cond.notify_all();
+    }
+    std::vector<std::thread> workers;
+    {
+        std::lock_guard<std::mutex> guard(m_jobs_mutex);
+        m_stop = true;
+        m_jobs.clear();
+        workers = std::move(m_workers);
+    }
+    m_jobs_cond.notify_all();
+    for (auto &thread : workers)
+        thread.join();
+}
+
+void STEPImportManager::set_update_handler(update_handler_t h)
+{
+    std::lock_guard<std::mutex> guard(m_handler_mutex);
+    m_update_handler = h;
+}
+
+void STEPImportManager::notify_update()
+{
+    update_handler_t handler;
+    {
+        std::lock_guard<std::mutex> guard(m_handler_mutex);
+        handler = m_update_handler;
+    }
+    if (handler)
+        handler();
+}
+
 STEPImportManager &STEPImportManager::get()
 {
-    static STEPImportManager instance;
-    return instance;
+    // never destroyed, the workers get stopped by shutdown() instead
+    static auto instance = new STEPImportManager;
+    return *instance;
 }
 
 static auto hash_file(const std::filesystem::path &path)
@@ -51,15 +103,6 @@ static auto hash_file(const std::filesystem::path &path)
 }
 
 namespace face {
-template <typename T> void to_json(json &j, const TVertex<T> &r)
-{
-    j = json::array();
-    j.push_back(r.x);
-    j.push_back(r.y);
-    j.push_back(r.z);
-}
-
-
 template <typename T> void from_json(const json &j, TVertex<T> &r)
 {
     j.at(0).get_to(r.x);
@@ -68,14 +111,6 @@ template <typename T> void from_json(const json &j, TVertex<T> &r)
 }
 
 
-void to_json(json &j, const Color &c)
-{
-    j = json::array();
-    j.push_back(c.r);
-    j.push_back(c.g);
-    j.push_back(c.b);
-}
-
 void from_json(const json &j, Color &c)
 {
     j.at(0).get_to(c.r);
@@ -83,14 +118,6 @@ void from_json(const json &j, Color &c)
     j.at(2).get_to(c.b);
 }
 
-void to_json(json &j, const Face &f)
-{
-    j = {{"color", f.color},
-         {"vertices", f.vertices},
-         {"normals", f.normals},
-         {"triangle_indices", f.triangle_indices}};
-}
-
 void from_json(const json &j, Face &f)
 {
     j.at("color").get_to(f.color);
@@ -103,11 +130,6 @@ void from_json(const json &j, Face &f)
 
 namespace STEPImporter {
 
-static void to_json(json &j, const Result &r)
-{
-    j = {{"faces", r.faces}, {"points", r.points}, {"edges", r.edges}};
-}
-
 static void from_json(const json &j, Result &r)
 {
 
@@ -119,61 +141,308 @@ static void from_json(const json &j, Result &r)
 } // namespace STEPImporter
 
 
+std::optional<STEPImportManager::FileStat> STEPImportManager::get_file_stat(const std::filesystem::path &path)
+{
+    GStatBuf st;
+    if (g_stat(path_to_string(path).c_str(), &st) != 0)
+        return {};
+    std::error_code ec;
+    const auto mtime = fs::last_write_time(path, ec);
+    if (ec)
+        return {};
+    FileStat r;
+    r.size = st.st_size;
+    r.mtime = mtime;
+    r.inode = st.st_ino;
+    return r;
+}
+
+static size_t get_memory_usage(const STEPImporter::Result &result)
+{
+    // shapes aren't accounted for as there's no easy way of finding out how big they are
+    size_t r = result.points.size() * sizeof(STEPImporter::Point);
+    for (const auto &face : result.faces) {
+        r += (face.vertices.size() + face.normals.size()) * sizeof(face::Vertex);
+        r += face.triangle_indices.size() * sizeof(face.triangle_indices.front());
+    }
+    for (const auto &edge : result.edges)
+        r += edge.size() * sizeof(STEPImporter::Point);
+    return r;
+}
+
+void STEPImportManager::evict_unused()
+{
+    std::vector<std::pair<uint64_t, std::filesystem::path>> unused;
+    size_t total = 0;
+    for (const auto &[path, entry] : m_imported) {
+        if (entry.handle.expired() && entry.imported->ready) {
+            unused.emplace_back(entry.last_used, path);
+            total += get_memory_usage(entry.imported->result);
+        }
+    }
+    if (total <= s_unused_budget)
+        return;
+
+    std::sort(unused.begin(), unused.end());
+    for (const auto &[last_used, path] : unused) {
+        if (total <= s_unused_budget)
+            break;
+        total -= get_memory_usage(m_imported.at(path).imported->result);
+        m_imported.erase(path);
+    }
+}
+
+std::shared_ptr<ImportedSTEP> STEPImportManager::get_handle(Entry &entry)
+{
+    if (auto handle = entry.handle.lock())
+        return handle;
+    auto imported = entry.imported;
+    auto handle = std::shared_ptr<ImportedSTEP>(imported.get(), [imported](ImportedSTEP *) {
+        // whatever needed it is gone, e.g. the document got closed or the tool importing it got cancelled
+        if (!imported->ready)
+            imported->cancelled = true;
+    });
+    entry.handle = handle;
+    return handle;
+}
+
 std::shared_ptr<ImportedSTEP> STEPImportManager::import_step(const std::filesystem::path &path)
 {
-    auto hash = hash_file(path);
+    const auto stat = get_file_stat(path);
+    auto imported = std::make_shared<ImportedSTEP>(path);
+    std::shared_ptr<ImportedSTEP> handle;
+    {
+        std::lock_guard<std::mutex> guard(m_mutex);
+        const auto use = ++m_use_counter;
+
+        if (auto it = m_imported.find(path); it != m_imported.end()) {
+            auto &entry = it->second;
+            // cancelled imports are on their way out, so start over
+            if (stat && entry.stat == stat && !entry.imported->cancelled) {
+                entry.last_used = use;
+                return get_handle(entry);
+            }
+        }
+
+        m_imported.erase(path);
+        auto &entry = m_imported.emplace(path, Entry{imported, {}, stat, use}).first->second;
+        handle = get_handle(entry);
+        evict_unused();
+    }
 
-    if (m_imported.contains(path)) {
-        auto &imported = m_imported.at(path);
-        if (imported->hash == hash)
-            return m_imported.at(path);
+    // hashing and loading from the cache take a while as well, so they're done in the background
+    {
+        std::lock_guard<std::mutex> guard(m_jobs_mutex);
+        if (m_workers.empty() && !m_stop) {
+            // a single import barely uses more than one core, so allow for a couple at once
+            const auto n_workers = std::clamp(std::thread::hardware_concurrency() / 2, 1u, 4u);
+            for (unsigned int i = 0; i < n_workers; i++)
+                m_workers.emplace_back(&STEPImportManager::worker, this);
+        }
+        if (!m_stop)
+            m_jobs.push_back(imported);
+        else
+            imported->cancelled = true;
     }
+    m_jobs_cond.notify_one();
+    return handle;
+}
 
-    auto imported = std::make_shared<ImportedSTEP>(path, hash);
-    imported->ready = true;
-    bool cache_ok = false;
+void STEPImportManager::wait_for_imports()
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_done_cond.wait(lock, [this] {
+        return std::ranges::all_of(m_imported, [](const auto &it) {
+            const auto &imported = *it.second.imported;
+            return imported.ready || imported.cancelled;
+        });
+    });
+}
 
-    auto cache_path = get_cache_dir() / (hash + ".ubjson");
+void STEPImportManager::worker()
+{
+    while (true) {
+        std::shared_ptr<ImportedSTEP> imported;
+        {
+            std::unique_lock<std::mutex> lock(m_jobs_mutex);
+            m_jobs_cond.wait(lock, [this] { return m_stop || m_jobs.size(); });
+            if (m_stop)
+                return;
+            imported = std::move(m_jobs.front());
+            m_jobs.pop_front();
+        }
+        import_in_background(imported);
+    }
+}
 
-    if (fs::exists(cache_path)) {
-        // json::from_ubjson(
-        auto rd = Glib::file_get_contents(cache_path.string());
-        auto j = json::from_ubjson(std::span(rd.data(), rd.size()));
-        if (j.contains("edges")) {
-            j.get_to(imported->result);
-            cache_ok = true;
+void STEPImportManager::import_in_background(const std::shared_ptr<ImportedSTEP> &imported)
+{
+    // set once the handle returned by import_step is gone or on shutdown
+    auto should_cancel = [&imported] { return imported->cancelled.load(); };
+
+    auto forget = [this, &imported] {
+        imported->cancelled = true;
+        std::lock_guard<std::mutex> guard(m_mutex);
+        // so that importing this file again starts over
+        auto it = m_imported.find(imported->path);
+        if (it != m_imported.end() && it->second.imported == imported)
+            m_imported.erase(it);
+        m_done_cond.notify_all();
+    };
+
+    auto finish = [this, &imported] {
+        {
+            std::lock_guard<std::mutex> guard(m_mutex);
+            imported->ready = true;
+            m_done_cond.notify_all();
         }
+        notify_update();
+    };
+
+    if (should_cancel()) {
+        forget();
+        return;
     }
 
+    imported->hash = hash_file(imported->path);
+    const auto cache_path = get_cache_path(imported->hash);
+    bool cache_ok = STEPImporter::load_cache(cache_path, imported->result);
+
     if (!cache_ok) {
-        imported->result = STEPImporter::import(path.generic_string());
-        json j = imported->result;
-        auto bs = json::to_ubjson(j);
-        Glib::file_set_contents(cache_path.string(), reinterpret_cast<const gchar *>(bs.data()), bs.size());
-        // save_json_to_file(cache_path, j);
+        // caches from before the binary format, converted once and then removed
+        auto legacy_cache_path = get_cache_dir() / (imported->hash + ".ubjson");
+        if (fs::exists(legacy_cache_path)) {
+            try {
+                auto rd = Glib::file_get_contents(path_to_string(legacy_cache_path));
+                auto j = json::from_ubjson(std::span(rd.data(), rd.size()));
+                if (j.contains("edges")) {
+                    j.get_to(imported->result);
+                    cache_ok = true;
+                    STEPImporter::save_cache(cache_path, imported->result);
+                }
+            }
+            catch (const std::exception &) {
+                // not worth keeping, the file gets imported again below
+                imported->result.faces.clear();
+                imported->result.points.clear();
+                imported->result.edges.clear();
+            }
+            fs::remove(legacy_cache_path);
+        }
+    }
+
+    if (cache_ok) {
+        finish();
+        return;
+    }
+
+    if (should_cancel()) {
+        forget();
+        return;
+    }
+
+    STEPImporter::ImportProgress progress;
+    progress.on_bbox = [this, &imported](const STEPImporter::Point &a, const STEPImporter::Point &b) {
+        imported->set_bbox({a, b});
+        notify_update();
+    };
+    unsigned int last_percent = 0;
+    progress.on_face = [this, &imported, &should_cancel, &last_percent](unsigned int done, unsigned int total) {
+        if (should_cancel())
+            return false;
+        imported->set_progress({done, total});
+        const unsigned int percent = total ? done * 100 / total : 0;
+        if (percent >= last_percent + 5) {
+            last_percent = percent;
+            notify_update();
+        }
+        return true;
+    };
+
+    auto result = STEPImporter::import(imported->path, progress);
+    if (should_cancel()) {
+        forget();
+        return;
+    }
+
+    STEPImporter::save_cache(cache_path, result);
+    if (result.shapes)
+        STEPImporter::save_shapes_cache(get_shapes_cache_path(imported->hash), *result.shapes);
+    {
+        std::lock_guard<std::mutex> guard(m_mutex);
+        // shapes may have been loaded in the meantime, so leave them alone
+        if (!imported->result.shapes)
+            imported->result.shapes = std::move(result.shapes);
     }
-    m_imported.erase(path);
-    m_imported.emplace(path, imported);
-    return imported;
+    imported->result.faces = std::move(result.faces);
+    imported->result.points = std::move(result.points);
+    imported->result.edges = std::move(result.edges);
+    finish();
 }
 
-void STEPImportManager::load_shapes(const ImportedSTEP &imported)
+const STEPImporter::Shapes *STEPImportManager::load_shapes(const ImportedSTEP &imported)
 {
-    auto &it = m_imported.at(imported.path);
-    if (it.get() != &imported)
-        return;
+    // whoever needs the shapes is expected to try again once the import is ready,
+    // parsing the file here would do the background import's work a second time
+    if (!imported.ready)
+        return nullptr;
+
+    std::shared_ptr<ImportedSTEP> entry_imported;
+    {
+        std::lock_guard<std::mutex> guard(m_mutex);
+        auto it = m_imported.find(imported.path);
+        if (it == m_imported.end() || it->second.imported.get() != &imported)
+            return imported.result.shapes.get();
+        entry_imported = it->second.imported;
+        if (entry_imported->result.shapes)
+            return entry_imported->result.shapes.get();
+    }
+
+    // loading or parsing takes a while, so don't block other imports meanwhile
+    const auto cache_path = get_shapes_cache_path(imported.hash);
+    auto shapes = STEPImporter::load_shapes_cache(cache_path);
+    if (!shapes) {
+        // only happens for files whose mesh got cached before there was a shapes cache
+        shapes = STEPImporter::import_shapes(imported.path);
+        if (shapes)
+            STEPImporter::save_shapes_cache(cache_path, *shapes);
+    }
 
-    it->result.shapes = STEPImporter::import_shapes(imported.path);
+    std::lock_guard<std::mutex> guard(m_mutex);
+    // another thread may have gotten there first and handed out its shapes already
+    if (!entry_imported->result.shapes)
+        entry_imported->result.shapes = std::move(shapes);
+    return entry_imported->result.shapes.get();
 }
 
-const STEPImporter::Shapes *ImportedSTEP::get_shapes() const
+std::optional<ImportedSTEP::BBox> ImportedSTEP::get_bbox() const
 {
-    if (result.shapes)
-        return result.shapes.get();
+    std::lock_guard<std::mutex> guard(m_mutex);
+    return m_bbox;
+}
+
+void ImportedSTEP::set_bbox(const BBox &bbox)
+{
+    std::lock_guard<std::mutex> guard(m_mutex);
+    m_bbox = bbox;
+}
+
+ImportedSTEP::Progress ImportedSTEP::get_progress() const
+{
+    std::lock_guard<std::mutex> guard(m_mutex);
+    return m_progress;
+}
+
+void ImportedSTEP::set_progress(const Progress &progress)
+{
+    std::lock_guard<std::mutex> guard(m_mutex);
+    m_progress = progress;
+}
 
-    auto &mgr = STEPImportManager::get();
-    mgr.load_shapes(*this);
-    return result.shapes.get();
+const STEPImporter::Shapes *ImportedSTEP::get_shapes() const
+{
+    // the shapes get set by the importing thread, so always go through the manager's lock
+    return STEPImportManager::get().load_shapes(*this);
 }
 
 } // namespace dune3d
@@ -1,7 +1,14 @@
 #pragma once
 #include <memory>
+#include <optional>
+#include <cstdint>
 #include <mutex>
 #include <map>
+#include <deque>
+#include <vector>
+#include <thread>
+#include <functional>
+#include <condition_variable>
 #include "imported_step.hpp"
 
 namespace dune3d {
@@ -9,12 +16,70 @@ namespace dune3d {
 class STEPImportManager {
 public:
     static STEPImportManager &get();
+    // files get hashed and imported or loaded from the cache in the background,
+    // the returned ImportedSTEP becomes ready once that's done; the import gets
+    // cancelled once nothing references the returned pointer anymore
     std::shared_ptr<ImportedSTEP> import_step(const std::filesystem::path &path);
-    void load_shapes(const ImportedSTEP &imported);
+    // returns nullptr if the import isn't ready yet
+    const STEPImporter::Shapes *load_shapes(const ImportedSTEP &imported);
+
+    // blocks until all imports requested so far are ready or cancelled,
+    // for when there's no main loop to handle the update handler
+    void wait_for_imports();
+
+    // called from the importing thread whenever an import made progress or finished
+    using update_handler_t = std::function<void()>;
+    void set_update_handler(update_handler_t h);
+
+    // cancels all imports and waits for the importing threads to exit, needs to be
+    // called before the process exits, imports requested afterwards never become ready
+    void shutdown();
 
 private:
     STEPImportManager();
-    std::map<std::filesystem::path, std::shared_ptr<ImportedSTEP>> m_imported;
+
+    // if none of these changed, the file is assumed to be unchanged and doesn't need to be hashed
+    struct FileStat {
+        uintmax_t size = 0;
+        std::filesystem::file_time_type mtime;
+        uint64_t inode = 0;
+
+        bool operator==(const FileStat &other) const = default;
+    };
+    static std::optional<FileStat> get_file_stat(const std::filesystem::path &path);
+
+    struct Entry {
+        std::shared_ptr<ImportedSTEP> imported;
+        // what import_step handed out, expires once no one uses this import anymore
+        std::weak_ptr<ImportedSTEP> handle;
+        std::optional<FileStat> stat;
+        uint64_t last_used = 0;
+    };
+    std::map<std::filesystem::path, Entry> m_imported;
+    uint64_t m_use_counter = 0;
+    // solid models may be rebuilt outside of the main thread
+    std::mutex m_mutex;
+    // notified with m_mutex held whenever an import got ready or cancelled
+    std::condition_variable m_done_cond;
+
+    // imports that aren't referenced anymore are kept around up to this many bytes,
+    // least recently used ones get dropped first
+    static constexpr size_t s_unused_budget = 512 * 1024 * 1024;
+    void evict_unused();
+    static std::shared_ptr<ImportedSTEP> get_handle(Entry &entry);
+
+    void worker();
+    void import_in_background(const std::shared_ptr<ImportedSTEP> &imported);
+    void notify_update();
+
+    std::mutex m_jobs_mutex;
+    std::condition_variable m_jobs_cond;
+    std::deque<std::shared_ptr<ImportedSTEP>> m_jobs;
+    bool m_stop = false;
+    std::vector<std::thread> m_workers;
+
+    std::mutex m_handler_mutex;
+    update_handler_t m_update_handler;
 };
 
 } // namespace dune3d
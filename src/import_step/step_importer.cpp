@@ -20,6 +20,8 @@
 #include <XCAFDoc_ShapeTool.hxx>
 
 #include <BRepMesh_IncrementalMesh.hxx>
+#include <BRepBndLib.hxx>
+#include <Bnd_Box.hxx>
 #include <BRep_Tool.hxx>
 
 #include <TopExp_Explorer.hxx>
@@ -53,6 +55,8 @@
 #include <glm/gtx/transform.hpp>
 #include <map>
 #include <list>
+#include <algorithm>
+#include <span>
 
 #include "util/fs_util.hpp"
 #include "shapes.hpp"
@@ -142,10 +146,6 @@ void STEPImporter::processWire(const TopoDS_Wire &wire, const glm::dmat4 &mat)
     }
 }
 
-#if OCC_VERSION_MAJOR >= 7 && OCC_VERSION_MINOR >= 6
-#define HORIZON_NEW_OCC
-#endif
-
 bool STEPImporter::processFace(const TopoDS_Face &face, Quantity_Color *color, const glm::dmat4 &mat)
 {
     if (Standard_True == face.IsNull())
@@ -163,25 +163,6 @@ bool STEPImporter::processFace(const TopoDS_Face &face, Quantity_Color *color, c
         }
     }
 
-    // bool reverse = ( face.Orientation() == TopAbs_REVERSED );
-
-    //	bool useBothSides = false;
-
-    TopLoc_Location loc;
-    Standard_Boolean isTessellate(Standard_False);
-    Handle(Poly_Triangulation) triangulation = BRep_Tool::Triangulation(face, loc);
-
-    if (triangulation.IsNull() || triangulation->Deflection() > USER_PREC + Precision::Confusion())
-        isTessellate = Standard_True;
-
-    if (isTessellate) {
-        BRepMesh_IncrementalMesh IM(face, USER_PREC, Standard_False, USER_ANGLE);
-        triangulation = BRep_Tool::Triangulation(face, loc);
-    }
-
-    if (triangulation.IsNull() == Standard_True)
-        return false;
-
     Quantity_Color lcolor;
 
     // check for a face color; this has precedence over SOLID colors
@@ -195,15 +176,7 @@ bool STEPImporter::processFace(const TopoDS_Face &face, Quantity_Color *color, c
         }
     } while (0);
 
-    Poly::ComputeNormals(triangulation);
-
-#ifndef HORIZON_NEW_OCC
-    const TColgp_Array1OfPnt &arrPolyNodes = triangulation->Nodes();
-    const Poly_Array1OfTriangle &arrTriangles = triangulation->Triangles();
-    const TShort_Array1OfShortReal &arrNormals = triangulation->Normals();
-#endif
-
-
+    // meshed later on in one go
     result->faces.emplace_back();
     auto &face_out = result->faces.back();
     if (color) {
@@ -214,63 +187,7 @@ bool STEPImporter::processFace(const TopoDS_Face &face, Quantity_Color *color, c
     else {
         face_out.color = {0.5, 0.5, 0.5};
     }
-    face_out.vertices.reserve(triangulation->NbNodes());
-
-    std::map<Vertex, std::vector<size_t>> pts_map;
-    for (int i = 1; i <= triangulation->NbNodes(); i++) {
-#ifdef HORIZON_NEW_OCC
-        gp_XYZ v(triangulation->Node(i).Coord());
-#else
-        gp_XYZ v(arrPolyNodes(i).Coord());
-#endif
-        const glm::vec4 vg(v.X(), v.Y(), v.Z(), 1);
-        const auto vt = mat * vg;
-        const Vertex vertex(vt.x, vt.y, vt.z);
-        pts_map[vertex].push_back(i - 1);
-        face_out.vertices.push_back(vertex);
-    }
-
-    face_out.normals.reserve(triangulation->NbNodes());
-    for (int i = 1; i <= triangulation->NbNodes(); i++) {
-#ifdef HORIZON_NEW_OCC
-        const auto n = triangulation->Normal(i);
-        glm::vec4 vg(n.X(), n.Y(), n.Z(), 0);
-#else
-        auto offset = (i - 1) * 3 + 1;
-        auto x = arrNormals(offset + 0);
-        auto y = arrNormals(offset + 1);
-        auto z = arrNormals(offset + 2);
-        glm::vec4 vg(x, y, z, 0);
-#endif
-        auto vt = mat * vg;
-        vt /= vt.length();
-        face_out.normals.emplace_back(vt.x, vt.y, vt.z);
-    }
-
-    // average normals at coincident vertices
-    for (const auto &[k, v] : pts_map) {
-        if (v.size() > 1) {
-            Vertex n_acc(0, 0, 0);
-            for (const auto idx : v) {
-                n_acc += face_out.normals.at(idx);
-            }
-            n_acc /= v.size();
-            for (const auto idx : v) {
-                face_out.normals.at(idx) = n_acc;
-            }
-        }
-    }
-
-    face_out.triangle_indices.reserve(triangulation->NbTriangles());
-    for (int i = 1; i <= triangulation->NbTriangles(); i++) {
-        int a, b, c;
-#ifdef HORIZON_NEW_OCC
-        triangulation->Triangle(i).Get(a, b, c);
-#else
-        arrTriangles(i).Get(a, b, c);
-#endif
-        face_out.triangle_indices.emplace_back(a - 1, b - 1, c - 1);
-    }
+    m_faces_to_mesh.push_back({face, mat, &face_out});
 
     return true;
 }
@@ -442,7 +359,7 @@ bool STEPImporter::processNode(const TopoDS_Shape &shape)
     return ret;
 }
 
-Result STEPImporter::get_faces_and_points()
+Result STEPImporter::get_faces_and_points(const ImportProgress &progress)
 {
     Result res;
     result = &res;
@@ -451,6 +368,21 @@ Result STEPImporter::get_faces_and_points()
     m_assy->GetFreeShapes(frshapes);
 
     int nshapes = frshapes.Length();
+    {
+        Bnd_Box bbox;
+        for (int i = 1; i <= nshapes; i++) {
+            TopoDS_Shape shape = m_assy->GetShape(frshapes.Value(i));
+            if (shape.IsNull())
+                continue;
+            BRepBndLib::Add(shape, bbox);
+        }
+        if (progress.on_bbox && !bbox.IsVoid()) {
+            double xmin, ymin, zmin, xmax, ymax, zmax;
+            bbox.Get(xmin, ymin, zmin, xmax, ymax, zmax);
+            progress.on_bbox(Point(xmin, ymin, zmin), Point(xmax, ymax, zmax));
+        }
+    }
+
     int id = 1;
     std::cout << "shapes " << nshapes << std::endl;
     while (id <= nshapes) {
@@ -490,10 +422,44 @@ Result STEPImporter::get_faces_and_points()
         ++id;
     }
 
+    const bool completed = mesh_faces(progress);
     result = nullptr;
+    m_faces_to_mesh.clear();
+    if (!completed)
+        return {};
+
+    // the shapes come from the same document, so they don't need to be read again later on
+    auto shapes = std::make_shared<Shapes>();
+    shapes->shapes = get_shapes();
+    res.shapes = shapes;
     return res;
 }
 
+bool STEPImporter::mesh_faces(const ImportProgress &progress)
+{
+    // meshing in batches rather than all at once lets us report progress
+    // and cancel while still keeping all cores busy
+    const size_t total = m_faces_to_mesh.size();
+    const size_t batch_size = std::max<size_t>(256, total / 50);
+    std::span<FaceToMesh> faces{m_faces_to_mesh};
+    for (size_t done = 0; done < total;) {
+        const auto n = std::min(batch_size, total - done);
+        dune3d::mesh_faces(faces.subspan(done, n), USER_PREC, USER_ANGLE);
+        done += n;
+        if (progress.on_face && !progress.on_face(done, total))
+            return false;
+    }
+
+    // faces that couldn't be meshed don't show up in the result
+    Faces faces_meshed;
+    for (auto &it : m_faces_to_mesh) {
+        if (it.ok)
+            faces_meshed.push_back(std::move(*it.out));
+    }
+    result->faces = std::move(faces_meshed);
+    return true;
+}
+
 std::vector<TopoDS_Shape> STEPImporter::get_shapes()
 {
     std::vector<TopoDS_Shape> r;
@@ -513,12 +479,12 @@ std::vector<TopoDS_Shape> STEPImporter::get_shapes()
     return r;
 }
 
-Result import(const std::filesystem::path &filename)
+Result import(const std::filesystem::path &filename, const ImportProgress &progress)
 {
     STEPImporter importer(filename);
     if (!importer.is_loaded())
         return {};
-    return importer.get_faces_and_points();
+    return importer.get_faces_and_points(progress);
 }
 
 std::shared_ptr<const Shapes> import_shapes(const std::filesystem::path &filename)
@@ -9,13 +9,14 @@
 #include <XCAFDoc_ColorTool.hxx>
 #include <glm/glm.hpp>
 #include <filesystem>
+#include "util/face_mesh.hpp"
 
 namespace dune3d::STEPImporter {
 class STEPImporter {
 public:
     STEPImporter(const std::filesystem::path &filename);
 
-    Result get_faces_and_points();
+    Result get_faces_and_points(const ImportProgress &progress = {});
     bool is_loaded() const
     {
         return loaded;
@@ -39,6 +40,9 @@ private:
     bool hasSolid;
     bool loaded = false;
 
+    bool mesh_faces(const ImportProgress &progress);
+
     Result *result;
+    std::vector<FaceToMesh> m_faces_to_mesh;
 };
 } // namespace dune3d::STEPImporter
@@ -15,6 +15,7 @@ Logger &Logger::get()
 
 void Logger::log(Logger::Level l, const std::string &m, Logger::Domain d, const std::string &detail)
 {
+    std::lock_guard<std::mutex> guard(mutex);
     if (handler) {
         handler(Item(seq++, l, m, d, detail));
     }
@@ -45,6 +46,7 @@ void Logger::log_warning(const std::string &message, Domain domain, const std::s
 
 void Logger::set_log_handler(Logger::log_handler_t h)
 {
+    std::lock_guard<std::mutex> guard(mutex);
     if (handler)
         return;
     handler = h;
@@ -4,6 +4,7 @@
 #include <string>
 #include <tuple>
 #include <cstdint>
+#include <mutex>
 
 namespace dune3d {
 class Logger {
@@ -57,6 +58,8 @@ public:
     void set_log_handler(log_handler_t handler);
 
 private:
+    // things get logged from worker threads as well
+    std::mutex mutex;
     log_handler_t handler = nullptr;
     std::deque<Item> buffer;
     uint64_t seq = 0;
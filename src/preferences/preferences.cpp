@@ -192,6 +192,7 @@ json EditorPreferences::serialize() const
     j["preview_constraints"] = preview_constraints;
     j["constraint_value_rounding"] = constraint_value_rounding;
     j["constraint_trailing_zeros"] = trailing_zeros_lut.lookup_reverse(constraint_trailing_zeros);
+    j["parallel_rebuild"] = parallel_rebuild;
     return j;
 }
 
@@ -201,6 +202,7 @@ void EditorPreferences::load_from_json(const json &j)
     constraint_value_rounding = j.value("constraint_value_rounding", 3);
     constraint_trailing_zeros =
             trailing_zeros_lut.lookup(j.value("constraint_trailing_zeros", "one_decimal"), TrailingZeros::ONE_DECIMAL);
+    parallel_rebuild = j.value("parallel_rebuild", true);
 }
 
 
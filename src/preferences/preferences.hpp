@@ -43,6 +43,7 @@ public:
     int constraint_value_rounding = 3;
     enum class TrailingZeros { OFF, ONE_DECIMAL, ON };
     TrailingZeros constraint_trailing_zeros = TrailingZeros::ONE_DECIMAL;
+    bool parallel_rebuild = true;
 
     void load_from_json(const json &j);
     json serialize() const;
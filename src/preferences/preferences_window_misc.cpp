@@ -93,6 +93,13 @@ MiscPreferencesEditor::MiscPreferencesEditor(Preferences &prefs) : m_preferences
             r->bind();
             gr->add_row(*r);
         }
+        {
+            auto r = Gtk::make_managed<PreferencesRowBool>(
+                    "Parallel rebuild",
+                    "Solve and rebuild independent groups concurrently, turn off to debug rebuild problems",
+                    m_preferences, m_preferences.editor.parallel_rebuild);
+            gr->add_row(*r);
+        }
     }
     {
         auto gr = Gtk::make_managed<PreferencesGroup>("Action Bar");
@@ -5,6 +5,8 @@
 #include "document/group/group.hpp"
 #include "document/group/igroup_solid_model.hpp"
 #include "document/solid_model/solid_model.hpp"
+#include "import_step/step_import_manager.hpp"
+#include "util/task_graph.hpp"
 #include "preferences/preferences.hpp"
 #include "util/text_render.hpp"
 #include "util/fs_util.hpp"
@@ -20,6 +22,12 @@ PYBIND11_MODULE(dune3d_py, m)
     Glib::init();
     Pango::init();
 
+    // background STEP imports and the task graph threads must not outlive the interpreter
+    py::module_::import("atexit").attr("register")(py::cpp_function([] {
+        STEPImportManager::get().shutdown();
+        TaskGraph::shutdown_threads();
+    }));
+
     py::class_<SolidModel>(m, "SolidModel").def("export_stl", [](SolidModel &solid_model, const std::string &path) {
         solid_model.export_stl(path_from_string(path));
     });
@@ -37,7 +45,14 @@ PYBIND11_MODULE(dune3d_py, m)
 
     py::class_<Document>(m, "Document")
             .def_static("new_from_file",
-                        [](const std::string &path) { return Document::new_from_file(path_from_string(path)); })
+                        [](const std::string &path) {
+                            auto doc = Document::new_from_file(path_from_string(path));
+                            // there's no main loop for picking up STEP imports once they're done
+                            STEPImportManager::get().wait_for_imports();
+                            if (doc.set_step_solid_models_pending())
+                                doc.update_pending();
+                            return doc;
+                        })
             .def("get_groups_sorted",
                  static_cast<const std::vector<Group *> &(Document::*)()>(&Document::get_groups_sorted),
                  py::return_value_policy::reference)
@@ -47,6 +62,7 @@ PYBIND11_MODULE(dune3d_py, m)
                         PangoFontMap *font_map = pango_cairo_font_map_get_default();
                         PangoContext *ctx = pango_font_map_create_context(font_map);
                         render_text(*en, Glib::wrap(ctx), doc);
+                        doc.set_item_changed(uu);
                         doc.set_group_generate_pending(en->m_group);
                     }
                 }
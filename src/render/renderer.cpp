@@ -89,11 +89,9 @@ void Renderer::render(const Document &doc, const UUID &current_group, const IDoc
         if (last_solid_model) {
             m_ca.add_face_group(last_solid_model->m_faces, {0, 0, 0}, glm::quat_identity<float, glm::defaultp>(),
                                 ICanvas::FaceColor::SOLID_MODEL);
-            for (const auto &[edge_idx, path] : last_solid_model->m_edges) {
-                for (size_t i = 1; i < path.size(); i++) {
-                    m_ca.add_selectable(m_ca.draw_line(path.at(i - 1), path.at(i)),
-                                        SelectableRef{SelectableRef::Type::SOLID_MODEL_EDGE, UUID(), edge_idx});
-                }
+            for (const auto &edge : last_solid_model->m_edges.m_edges) {
+                m_ca.add_selectable(m_ca.draw_polyline(last_solid_model->m_edges.get_path(edge)),
+                                    SelectableRef{SelectableRef::Type::SOLID_MODEL_EDGE, UUID(), edge.index});
             }
         }
 
@@ -104,16 +102,15 @@ void Renderer::render(const Document &doc, const UUID &current_group, const IDoc
         return;
     }
 
+    const Document::ItemIndex item_index{doc};
     for (auto &[uu, group] : doc.get_groups()) {
         if (group->get_index() < first_group_index)
             continue;
         if (!group_is_visible(group->m_uuid))
             continue;
         set_chunk_from_group(*group);
-        for (const auto &[uu, el] : doc.m_entities) {
-            if (el->m_group == group->m_uuid)
-                render(*el);
-        }
+        for (auto el : item_index.get_entities(group->m_uuid))
+            render(*el);
     }
 
 
@@ -121,14 +118,14 @@ void Renderer::render(const Document &doc, const UUID &current_group, const IDoc
     for (auto body_groups : groups_by_body) {
         if (!m_doc_view->body_solid_model_is_visible(body_groups.get_group().m_uuid))
             continue;
-        const SolidModel *last_solid_model = nullptr;
+        std::shared_ptr<const SolidModel> last_solid_model;
         const Group *last_solid_model_group = nullptr;
         for (auto group : body_groups.groups) {
             if (!group_is_visible(group->m_uuid))
                 continue;
             if (auto gr = dynamic_cast<const IGroupSolidModel *>(group)) {
-                if (gr->get_solid_model()) {
-                    last_solid_model = gr->get_solid_model();
+                if (auto solid_model = gr->get_solid_model_shared()) {
+                    last_solid_model = std::move(solid_model);
                     last_solid_model_group = group;
                 }
                 if (group->m_uuid == current_group)
@@ -143,8 +140,10 @@ void Renderer::render(const Document &doc, const UUID &current_group, const IDoc
             if (body_groups.body.m_color.has_value())
                 color = ICanvas::FaceColor::AS_IS;
             set_chunk_from_group(*last_solid_model_group);
-            const auto vref = m_ca.add_face_group(last_solid_model->m_faces, {0, 0, 0},
-                                                  glm::quat_identity<float, glm::defaultp>(), color);
+            // shares the mesh with linked documents showing the same solid model
+            const auto vref = m_ca.add_face_group_instance(
+                    std::shared_ptr<const face::Faces>(last_solid_model, &last_solid_model->m_faces), glm::mat4(1),
+                    color);
             if (sr)
                 m_ca.add_selectable(vref, *sr);
         }
@@ -153,14 +152,12 @@ void Renderer::render(const Document &doc, const UUID &current_group, const IDoc
 
     if (!sr) {
         set_chunk_from_group(*m_current_group);
-        for (const auto &[uu, el] : doc.m_constraints) {
-            if (m_current_group->m_uuid != el->m_group)
-                continue;
+        for (auto el : item_index.get_constraints(m_current_group->m_uuid)) {
             try {
                 el->accept(*this);
             }
             catch (const std::exception &ex) {
-                Logger::log_critical("exception rendering constraint " + static_cast<std::string>(uu),
+                Logger::log_critical("exception rendering constraint " + static_cast<std::string>(el->m_uuid),
                                      Logger::Domain::RENDERER, ex.what());
             }
         }
@@ -467,22 +464,32 @@ void Renderer::visit(const EntitySTEP &en)
         display = view->m_display;
 
     SelectableRef sr{SelectableRef::Type::ENTITY, en.m_uuid, 0};
-    if (en.m_imported) {
+    if (en.m_imported && !en.m_imported->ready) {
+        render_step_placeholder(en);
+    }
+    else if (en.m_imported) {
         if (any_of(display, EntityViewSTEP::Display::SOLID, EntityViewSTEP::Display::SOLID_WIREFRAME)
-            && !en.m_include_in_solid_model)
-            m_ca.add_selectable(m_ca.add_face_group(en.m_imported->result.faces, en.m_origin, en.m_normal,
-                                                    ICanvas::FaceColor::AS_IS),
-                                sr);
+            && !en.m_include_in_solid_model) {
+            // all placements of the same file share one mesh
+            const auto transform =
+                    glm::translate(glm::mat4(1), glm::vec3(en.m_origin)) * glm::toMat4(glm::quat(en.m_normal));
+            m_ca.add_selectable(
+                    m_ca.add_face_group_instance(
+                            std::shared_ptr<const face::Faces>(en.m_imported, &en.m_imported->result.faces),
+                            transform, ICanvas::FaceColor::AS_IS),
+                    sr);
+        }
 
         if (any_of(display, EntityViewSTEP::Display::WIREFRAME, EntityViewSTEP::Display::SOLID_WIREFRAME)) {
+            std::vector<glm::vec3> points;
+            std::vector<size_t> path_sizes;
+            path_sizes.reserve(en.m_imported->result.edges.size());
             for (const auto &path : en.m_imported->result.edges) {
-                for (size_t i = 1; i < path.size(); i++) {
-                    const auto &a = path.at(i - 1);
-                    const auto &b = path.at(i);
-                    m_ca.add_selectable(m_ca.draw_line(en.transform({a.x, a.y, a.z}), en.transform({b.x, b.y, b.z})),
-                                        sr);
-                }
+                for (const auto &pt : path)
+                    points.push_back(en.transform({pt.x, pt.y, pt.z}));
+                path_sizes.push_back(path.size());
             }
+            m_ca.add_selectable(m_ca.draw_polylines(points, path_sizes), sr);
         }
         if (en.m_show_points) {
             unsigned int idx = EntitySTEP::s_imported_point_offset;
@@ -494,6 +501,34 @@ void Renderer::visit(const EntitySTEP &en)
     }
 }
 
+// shown while the import is still running in the background
+void Renderer::render_step_placeholder(const EntitySTEP &en)
+{
+    SelectableRef sr{SelectableRef::Type::ENTITY, en.m_uuid, 0};
+    const auto progress = en.m_imported->get_progress();
+    std::string label = "importing " + path_to_string(en.m_path.filename());
+    if (progress.faces_total)
+        label += " " + std::to_string(std::min(progress.faces_done * 100 / progress.faces_total, 100u)) + "%";
+
+    const auto bbox = en.m_imported->get_bbox();
+    if (!bbox) {
+        add_selectables(sr, m_ca.draw_bitmap_text(en.m_origin, 1, label));
+        return;
+    }
+
+    const auto &[a, b] = *bbox;
+    auto corner = [&en, &a, &b](unsigned int i) {
+        return en.transform({(i & 1) ? b.x : a.x, (i & 2) ? b.y : a.y, (i & 4) ? b.z : a.z});
+    };
+    for (unsigned int i = 0; i < 8; i++) {
+        for (unsigned int axis = 1; axis < 8; axis <<= 1) {
+            if (!(i & axis))
+                m_ca.add_selectable(m_ca.draw_line(corner(i), corner(i | axis)), sr);
+        }
+    }
+    add_selectables(sr, m_ca.draw_bitmap_text(corner(0), 1, label));
+}
+
 class FakeDocumentView : public IDocumentView {
 public:
     bool document_is_visible() const override
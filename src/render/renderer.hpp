@@ -120,6 +120,7 @@ private:
                                            const glm::vec3 &text_p, const std::string &label, const UUID &uu,
                                            const glm::vec3 &fallback_normal = {NAN, NAN, NAN});
     void add_selectables(const SelectableRef &sr, const std::vector<ICanvas::VertexRef> &vrs);
+    void render_step_placeholder(const EntitySTEP &en);
 
     struct State {
         bool no_bezier_control_lines = false;
@@ -30,8 +30,10 @@
 #include <array>
 #include <set>
 #include <iostream>
+#include <optional>
+#include <stdexcept>
 
-Sketch SolveSpace::SK = {};
+thread_local Sketch SolveSpace::SK = {};
 
 void SolveSpace::Platform::FatalError(const std::string &message)
 {
@@ -46,52 +48,82 @@ void Group::GenerateEquations(IdList<Equation, hEquation> *)
 
 namespace dune3d {
 
+struct System::Session {
+    // equations added by us rather than generated by SolveSpace, these get
+    // modified when solving, so keep pristine copies
+    std::vector<Equation> equations;
 
-static std::mutex s_sys_mutex;
+    // parameters being solved for
+    std::vector<hParam> params;
 
-System::System(Document &doc, const UUID &grp, const UUID &constraint_exclude)
-    : m_sys(std::make_unique<SolveSpace::System>()), m_doc(doc), m_solve_group(grp), m_lock(s_sys_mutex)
-{
-    auto &solve_group = doc.get_group(m_solve_group);
-    for (auto &[uu, constraint] : m_doc.m_constraints) {
-        if (constraint->m_group == m_solve_group)
-            if (auto ps = dynamic_cast<const IConstraintPreSolve *>(constraint.get()))
-                ps->pre_solve(m_doc);
-    }
-    if (auto ps = dynamic_cast<const IGroupPreSolve *>(&solve_group)) {
-        ps->pre_solve(m_doc);
-    }
+    struct EntityParam {
+        hParam param;
+        const Entity *entity;
+        unsigned int point;
+        unsigned int axis;
+    };
+    std::vector<EntityParam> entity_params;
 
-    std::set<Entity *> entities;
-    std::set<Constraint *> constraints;
-    for (const auto &[uu, entity] : m_doc.m_entities) {
-        if (entity->m_group != m_solve_group)
-            continue;
-        entities.insert(entity.get());
+    std::vector<const IConstraintPreSolve *> pre_solve_constraints;
+    const IGroupPreSolve *pre_solve_group = nullptr;
+
+    // everything allocated after this is scratch space of the last solve
+    Platform::TemporaryMark mark;
+
+    // params whose value changed since the last solve
+    std::set<uint32_t> changed_params;
+
+    // of the last solve, components that didn't change don't need solving again
+    struct ComponentResult {
+        ::SolveResult how;
+        int dof;
+    };
+    std::vector<ComponentResult> component_results;
+
+    // while suspended
+    decltype(SK.param) sk_param;
+    decltype(SK.entity) sk_entity;
+    decltype(SK.constraint) sk_constraint;
+    Platform::TemporaryArena *arena = nullptr;
+};
+
+namespace {
+struct SystemItems {
+    std::set<const Entity *> entities;
+    std::set<const Constraint *> constraints;
+};
+} // namespace
+
+// entities and constraints that go into the system for the given group
+static SystemItems collect_items(const Document &doc, const UUID &group_uu, const UUID &constraint_exclude,
+                                 const Document::ItemIndex &index)
+{
+    SystemItems items;
+    auto &entities = items.entities;
+    for (auto entity : index.get_entities(group_uu)) {
+        entities.insert(entity);
         auto referenced_entities = entity->get_referenced_entities();
         for (const auto &uu : referenced_entities) {
             entities.insert(&doc.get_entity(uu));
         }
     }
-    for (const auto &[uu, constraint] : m_doc.m_constraints) {
-        if (constraint->m_group != m_solve_group)
-            continue;
-        if (uu == constraint_exclude)
+    for (auto constraint : index.get_constraints(group_uu)) {
+        if (constraint->m_uuid == constraint_exclude)
             continue;
-        constraints.insert(constraint.get());
+        items.constraints.insert(constraint);
         auto referenced_entities = constraint->get_referenced_entities();
         for (const auto &uu : referenced_entities) {
             entities.insert(&doc.get_entity(uu));
         }
     }
     {
-        auto referenced_entities = solve_group.get_referenced_entities(doc);
+        auto referenced_entities = doc.get_group(group_uu).get_referenced_entities(doc);
         for (const auto &uu : referenced_entities) {
             entities.insert(&doc.get_entity(uu));
         }
     }
     {
-        std::set<Entity *> other_entities;
+        std::set<const Entity *> other_entities;
         for (auto entity : entities) {
             auto referenced_entities = entity->get_referenced_entities();
             for (const auto &uu : referenced_entities) {
@@ -100,10 +132,46 @@ System::System(Document &doc, const UUID &grp, const UUID &constraint_exclude)
         }
         entities.insert(other_entities.begin(), other_entities.end());
     }
-    for (auto entity : entities) {
+    return items;
+}
+
+std::set<UUID> System::get_groups_read(const Document &doc, const UUID &group,
+                                       const Document::ItemIndex &index)
+{
+    std::set<UUID> groups;
+    for (auto entity : collect_items(doc, group, UUID(), index).entities) {
+        groups.insert(entity->m_group);
+    }
+    groups.erase(group);
+    return groups;
+}
+
+System::System(Document &doc, const UUID &grp, const UUID &constraint_exclude, const Document::ItemIndex *index)
+    : m_sys(std::make_unique<SolveSpace::System>()), m_doc(doc), m_solve_group(grp)
+{
+    std::unique_ptr<Document::ItemIndex> own_index;
+    if (!index) {
+        own_index = std::make_unique<Document::ItemIndex>(doc);
+        index = own_index.get();
+    }
+    m_index = index;
+
+    auto &solve_group = doc.get_group(m_solve_group);
+    for (auto constraint : m_index->get_constraints(m_solve_group)) {
+        if (auto ps = dynamic_cast<const IConstraintPreSolve *>(constraint)) {
+            ps->pre_solve(m_doc);
+            m_pre_solve_constraints.push_back(ps);
+        }
+    }
+    if (auto ps = dynamic_cast<const IGroupPreSolve *>(&solve_group)) {
+        ps->pre_solve(m_doc);
+    }
+
+    const auto items = collect_items(doc, m_solve_group, constraint_exclude, *m_index);
+    for (auto entity : items.entities) {
         entity->accept(*this);
     }
-    for (auto constraint : constraints) {
+    for (auto constraint : items.constraints) {
         constraint->accept(*this);
     }
 
@@ -132,6 +200,7 @@ System::System(Document &doc, const UUID &grp, const UUID &constraint_exclude)
         break;
     default:;
     }
+    m_index = nullptr;
 }
 
 void System::visit(const EntityLine3D &line)
@@ -837,9 +906,8 @@ void System::add(const GroupExtrude &group)
             AddEq(hg, &m_sys->eq, exp2.z->Minus(exp1.z->Plus(direction.z)), eqi++);
         }
 
-        for (const auto &[uu, it] : m_doc.m_entities) {
-            if (it->m_group != group.m_source_group)
-                continue;
+        for (auto it : m_index->get_entities(group.m_source_group)) {
+            const auto &uu = it->m_uuid;
             if (it->m_construction)
                 continue;
             if (it->get_type() == Entity::Type::LINE_2D) {
@@ -1022,9 +1090,8 @@ void System::add(const GroupLathe &group)
     unsigned int eqi = 0;
     const auto hg = hGroup{(uint32_t)group.get_index() + 1};
 
-    for (const auto &[uu, en] : m_doc.m_entities) {
-        if (en->m_group != m_solve_group)
-            continue;
+    for (auto en : m_index->get_entities(m_solve_group)) {
+        const auto &uu = en->m_uuid;
         if (en->m_kind != ItemKind::GENRERATED)
             continue;
         if (en->get_type() != Entity::Type::CIRCLE_3D)
@@ -1100,9 +1167,8 @@ void System::add(const GroupRevolve &group)
         auto quat = quat_from_axis_angle(ExprVector::From(axv.x, axv.y, axv.z), angle);
 
 
-        for (const auto &[uu, it] : m_doc.m_entities) {
-            if (it->m_group != group.m_source_group)
-                continue;
+        for (auto it : m_index->get_entities(group.m_source_group)) {
+            const auto &uu = it->m_uuid;
             if (it->m_construction)
                 continue;
             if (it->get_type() == Entity::Type::LINE_2D) {
@@ -1660,9 +1726,8 @@ void System::add(const GroupClone &group)
     auto source_wrkpl = hEntity{get_entity_ref(EntityRef{group.m_source_wrkpl, 0})};
     auto dest_wrkpl = hEntity{get_entity_ref(EntityRef{group.m_active_wrkpl, 0})};
 
-    for (const auto &[uu, it] : m_doc.m_entities) {
-        if (it->m_group != group.m_source_group)
-            continue;
+    for (auto it : m_index->get_entities(group.m_source_group)) {
+        const auto &uu = it->m_uuid;
         if (it->get_type() == Entity::Type::LINE_2D) {
             const auto &li = dynamic_cast<const EntityLine2D &>(*it);
             if (li.m_wrkpl != group.m_source_wrkpl)
@@ -1750,9 +1815,13 @@ void System::update_document()
     for (const auto &[idx, param_ref] : m_param_refs) {
         const auto val = SK.GetParam({idx})->val;
         switch (param_ref.type) {
-        case ParamRef::Type::ENTITY:
-            m_doc.m_entities.at(param_ref.item)->set_param(param_ref.point, param_ref.axis, val);
-            break;
+        case ParamRef::Type::ENTITY: {
+            auto &entity = *m_doc.m_entities.at(param_ref.item);
+            // params of other groups are known and thus didn't change, also they may
+            // be read by another group being solved concurrently
+            if (entity.m_group == m_solve_group)
+                entity.set_param(param_ref.point, param_ref.axis, val);
+        } break;
         case ParamRef::Type::GROUP:
             if (m_doc.get_group(param_ref.item).get_type() == Group::Type::EXTRUDE) {
                 if (param_ref.point == 0)
@@ -1856,11 +1925,9 @@ void System::update_document()
             c->m_beta2 = SK.GetParam(hConstraint{idx}.param(0x20000000))->val;
         }
     }
-    for (auto &[uu, group] : m_doc.get_groups()) {
-        if (auto gp = dynamic_cast<GroupPolarArray *>(group.get()); gp && gp->m_active_wrkpl) {
-            auto &en_center = m_doc.get_entity<EntityPoint2D>(gp->get_center_point_uuid());
-            gp->m_center = en_center.m_p;
-        }
+    if (auto gp = dynamic_cast<GroupPolarArray *>(&m_doc.get_group(m_solve_group)); gp && gp->m_active_wrkpl) {
+        auto &en_center = m_doc.get_entity<EntityPoint2D>(gp->get_center_point_uuid());
+        gp->m_center = en_center.m_p;
     }
 }
 
@@ -1928,8 +1995,99 @@ System::SolveResultWithDof System::solve(std::set<EntityAndPoint> *free_points)
     std::cout << "solve group " << gr.m_name << std::endl;
     List<hConstraint> bad = {};
     auto tbegin = clock();
-    int dof = -2;
-    ::SolveResult how = m_sys->Solve(&g, NULL, &dof, &bad, false, /*andFindFree=*/free_points != nullptr);
+    // stays at this if the solver doesn't get to calculate the DOF, e.g. when it
+    // doesn't converge or there are too many unknowns
+    constexpr int dof_unknown = -2;
+    int dof = dof_unknown;
+    ::SolveResult how = ::SolveResult::OKAY;
+    const bool find_free = free_points != nullptr;
+
+    m_sys->WriteEquationsExceptFor(ConstraintBase::NO_CONSTRAINT, &g);
+    m_sys->equationsWritten = true;
+
+    // only components affected by what changed since the last solve need solving again
+    std::set<uint32_t> changed_params;
+    const bool can_skip = m_session && m_session->component_results.size() && !find_free;
+    if (can_skip) {
+        changed_params = m_session->changed_params;
+        for (const auto hp : m_sys->dragged) {
+            changed_params.insert(hp.v);
+        }
+    }
+    const auto components = find_components(changed_params);
+    if (can_skip && m_session->component_results.size() != components.size()) {
+        // shouldn't happen as long as the topology is the same
+        m_session->component_results.clear();
+    }
+
+    if (components.size() <= 1) {
+        how = m_sys->Solve(&g, NULL, &dof, &bad, false, find_free);
+        if (m_session)
+            m_session->component_results = {{how, dof}};
+    }
+    else {
+        auto rank = [](::SolveResult r) {
+            switch (r) {
+            case ::SolveResult::OKAY:
+                return 0;
+            case ::SolveResult::REDUNDANT_OKAY:
+                return 1;
+            case ::SolveResult::DIDNT_CONVERGE:
+                return 2;
+            case ::SolveResult::REDUNDANT_DIDNT_CONVERGE:
+                return 3;
+            case ::SolveResult::TOO_MANY_UNKNOWNS:
+                return 4;
+            }
+            return 0;
+        };
+        std::vector<Session::ComponentResult> results;
+        results.reserve(components.size());
+        bool redundant = false;
+        // the sum is only meaningful if the DOF of every component is known
+        bool dof_known = true;
+        dof = 0;
+        for (size_t i = 0; i < components.size(); i++) {
+            const auto &component = components.at(i);
+            Session::ComponentResult result;
+            if (m_session && m_session->component_results.size() && !component.dirty) {
+                result = m_session->component_results.at(i);
+            }
+            else {
+                SolveSpace::System sys;
+                sys.equationsWritten = true;
+                for (const auto p : component.params) {
+                    sys.param.Add(m_sys->param.FindById(hParam{p}));
+                    if (m_sys->IsDragged(hParam{p})) {
+                        hParam hp = {p};
+                        sys.dragged.Add(&hp);
+                    }
+                }
+                for (const auto e : component.equations) {
+                    sys.eq.Add(m_sys->eq.FindById(hEquation{e}));
+                }
+                result.dof = dof_unknown;
+                result.how = sys.Solve(&g, NULL, &result.dof, &bad, false, find_free);
+                sys.Clear();
+            }
+            results.push_back(result);
+            if (result.dof < 0)
+                dof_known = false;
+            else
+                dof += result.dof;
+            if (result.how == ::SolveResult::REDUNDANT_OKAY || result.how == ::SolveResult::REDUNDANT_DIDNT_CONVERGE)
+                redundant = true;
+            if (rank(result.how) > rank(how))
+                how = result.how;
+        }
+        if (redundant && how == ::SolveResult::DIDNT_CONVERGE)
+            how = ::SolveResult::REDUNDANT_DIDNT_CONVERGE;
+        if (!dof_known)
+            dof = dof_unknown;
+        if (m_session)
+            m_session->component_results = std::move(results);
+    }
+
     auto tend = clock();
     std::cout << "how " << (int)how << " " << dof << " took " << (double)(tend - tbegin) / CLOCKS_PER_SEC << std::endl
               << std::endl;
@@ -1965,6 +2123,79 @@ System::SolveResultWithDof System::solve(std::set<EntityAndPoint> *free_points)
 }
 
 
+std::vector<System::Component> System::find_components(const std::set<uint32_t> &changed_params) const
+{
+    std::vector<uint32_t> params;
+    std::map<uint32_t, size_t> param_indices;
+    for (const auto &p : m_sys->param) {
+        param_indices.emplace(p.h.v, params.size());
+        params.push_back(p.h.v);
+    }
+
+    // union-find over the params being solved for
+    std::vector<size_t> parents(params.size());
+    for (size_t i = 0; i < parents.size(); i++) {
+        parents.at(i) = i;
+    }
+    auto find = [&parents](size_t i) {
+        while (parents.at(i) != i) {
+            parents.at(i) = parents.at(parents.at(i));
+            i = parents.at(i);
+        }
+        return i;
+    };
+
+    struct EquationInfo {
+        uint32_t h;
+        std::optional<size_t> param;
+        bool dirty = false;
+    };
+    std::vector<EquationInfo> equations;
+    std::vector<hParam> used;
+    for (const auto &eq : m_sys->eq) {
+        auto &info = equations.emplace_back();
+        info.h = eq.h.v;
+        used.clear();
+        eq.e->ParamsUsedList(&used);
+        for (const auto hp : used) {
+            if (changed_params.contains(hp.v))
+                info.dirty = true;
+            auto it = param_indices.find(hp.v);
+            if (it == param_indices.end())
+                continue;
+            if (info.param)
+                parents.at(find(it->second)) = find(*info.param);
+            else
+                info.param = it->second;
+        }
+    }
+
+    std::vector<Component> components;
+    std::map<size_t, size_t> root_to_component;
+    for (size_t i = 0; i < params.size(); i++) {
+        const auto root = find(i);
+        auto [it, inserted] = root_to_component.emplace(root, components.size());
+        if (inserted)
+            components.emplace_back();
+        auto &component = components.at(it->second);
+        component.params.push_back(params.at(i));
+        if (changed_params.contains(params.at(i)))
+            component.dirty = true;
+    }
+
+    for (const auto &info : equations) {
+        // equations without any unknowns still matter for detecting inconsistencies
+        if (components.empty())
+            components.emplace_back();
+        auto &component = info.param ? components.at(root_to_component.at(find(*info.param))) : components.front();
+        component.equations.push_back(info.h);
+        if (info.dirty)
+            component.dirty = true;
+    }
+
+    return components;
+}
+
 uint32_t System::add_param(const UUID &group_uu, double value)
 {
     auto idx = SK.param.n + 2;
@@ -2861,12 +3092,108 @@ int System::get_group_index(const Entity &en) const
 }
 
 
+void System::set_reusable()
+{
+    m_session = std::make_unique<Session>();
+    auto &session = *m_session;
+
+    session.pre_solve_constraints = m_pre_solve_constraints;
+    session.pre_solve_group = dynamic_cast<const IGroupPreSolve *>(&m_doc.get_group(m_solve_group));
+
+    for (const auto &[idx, param_ref] : m_param_refs) {
+        if (param_ref.type == ParamRef::Type::ENTITY)
+            session.entity_params.push_back(
+                    {hParam{idx}, m_doc.m_entities.at(param_ref.item).get(), param_ref.point, param_ref.axis});
+    }
+    for (const auto &p : m_sys->param) {
+        session.params.push_back(p.h);
+    }
+    for (const auto &eq : m_sys->eq) {
+        auto &eq_copy = session.equations.emplace_back(eq);
+        eq_copy.e = eq.e->DeepCopy();
+    }
+    session.mark = Platform::MarkTemporary();
+}
+
+void System::suspend()
+{
+    if (!m_session)
+        throw std::runtime_error("system isn't reusable");
+    if (m_suspended)
+        return;
+    auto &session = *m_session;
+    std::swap(session.sk_param, SK.param);
+    std::swap(session.sk_entity, SK.entity);
+    std::swap(session.sk_constraint, SK.constraint);
+    session.arena = Platform::DetachTemporary();
+    m_suspended = true;
+}
+
+void System::resume()
+{
+    if (!m_suspended)
+        return;
+    auto &session = *m_session;
+    Platform::AttachTemporary(session.arena);
+    session.arena = nullptr;
+    std::swap(session.sk_param, SK.param);
+    std::swap(session.sk_entity, SK.entity);
+    std::swap(session.sk_constraint, SK.constraint);
+    m_suspended = false;
+
+    Platform::FreeTemporaryToMark(session.mark);
+
+    for (auto ps : session.pre_solve_constraints) {
+        ps->pre_solve(m_doc);
+    }
+    if (session.pre_solve_group)
+        session.pre_solve_group->pre_solve(m_doc);
+
+    // group and constraint params keep their last solved values, same as the
+    // ones written to the document
+    session.changed_params.clear();
+    for (const auto &ep : session.entity_params) {
+        auto p = SK.GetParam(ep.param);
+        const auto val = ep.entity->get_param(ep.point, ep.axis);
+        if (p->val != val) {
+            p->val = val;
+            session.changed_params.insert(ep.param.v);
+        }
+    }
+    SK.constraint.ClearTags();
+
+    m_sys->param.Clear();
+    for (const auto hp : session.params) {
+        auto p = SK.GetParam(hp);
+        p->tag = 0;
+        p->known = false;
+        p->free = false;
+        p->substd = nullptr;
+        m_sys->param.Add(p);
+    }
+    m_sys->eq.Clear();
+    for (const auto &eq : session.equations) {
+        Equation eq_copy = eq;
+        eq_copy.e = eq.e->DeepCopy();
+        m_sys->eq.Add(&eq_copy);
+    }
+    m_sys->dragged.Clear();
+}
+
 System::~System()
 {
+    m_sys->Clear();
+    if (m_suspended) {
+        // our state isn't the calling thread's, so leave that alone and free the saved one
+        m_session->sk_param.Clear();
+        m_session->sk_entity.Clear();
+        m_session->sk_constraint.Clear();
+        Platform::FreeTemporaryArena(m_session->arena);
+        return;
+    }
     SK.param.Clear();
     SK.entity.Clear();
     SK.constraint.Clear();
-    m_sys->Clear();
     FreeAllTemporary();
 }
 
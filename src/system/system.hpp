@@ -1,7 +1,7 @@
 #pragma once
 #include <memory>
 #include <map>
-#include <mutex>
+#include <vector>
 #include <functional>
 #include "util/uuid.hpp"
 #include "document/constraint/all_constraints_fwd.hpp"
@@ -11,6 +11,7 @@
 #include "document/constraint/constraint_visitor.hpp"
 #include "document/entity/entity_and_point.hpp"
 #include "solve_result.hpp"
+#include "document/document.hpp"
 #include <set>
 
 
@@ -22,11 +23,15 @@ class ExprQuaternion;
 
 namespace dune3d {
 
-class Document;
+class IConstraintPreSolve;
 
+// SolveSpace's sketch and expression arena are thread-local, so Systems on
+// different threads can solve concurrently. Only one System may exist per thread at a time.
 class System : private EntityVisitor, private ConstraintVisitor {
 public:
-    System(Document &doc, const UUID &group, const UUID &constraint_exclude = UUID());
+    // index is only used while constructing, one is made if none is given
+    System(Document &doc, const UUID &group, const UUID &constraint_exclude = UUID(),
+           const Document::ItemIndex *index = nullptr);
 
     struct SolveResultWithDof {
         SolveResult result;
@@ -36,8 +41,25 @@ public:
 
     void update_document();
 
+    // groups other than the given one whose entities a System for it reads
+    static std::set<UUID> get_groups_read(const Document &doc, const UUID &group,
+                                          const Document::ItemIndex &index);
+
     void add_dragged(const UUID &entity, unsigned int point);
 
+    // Keeps a copy of the equations set up so far, so that the System can be
+    // solved again after resume() without being rebuilt. Call before solve().
+    void set_reusable();
+
+    // Detaches the solver state from the calling thread, so that other Systems
+    // can be used until resume() is called, possibly on another thread.
+    void suspend();
+
+    // Reattaches the solver state and reloads all parameter values from the
+    // document. Dragged parameters are cleared. Only valid if nothing but
+    // parameter values changed in the document since set_reusable().
+    void resume();
+
     ~System();
 
 private:
@@ -124,7 +146,22 @@ private:
     std::unique_ptr<SolveSpace::System> m_sys;
     Document &m_doc;
     const UUID m_solve_group;
-    std::lock_guard<std::mutex> m_lock;
+    // only set while constructing
+    const Document::ItemIndex *m_index = nullptr;
+    std::vector<const IConstraintPreSolve *> m_pre_solve_constraints;
+
+    struct Session;
+    std::unique_ptr<Session> m_session;
+    bool m_suspended = false;
+
+    // params connected by equations, these get solved independently of each other
+    struct Component {
+        std::vector<uint32_t> params;
+        std::vector<uint32_t> equations;
+        bool dirty = false;
+    };
+    // components are dirty if they use any of the given params
+    std::vector<Component> find_components(const std::set<uint32_t> &changed_params) const;
 
     unsigned int n_constraint = 1;
 
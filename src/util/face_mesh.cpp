@@ -0,0 +1,133 @@
+#include "face_mesh.hpp"
+#include <Standard_Version.hxx>
+#include <BRepMesh_IncrementalMesh.hxx>
+#include <BRep_Builder.hxx>
+#include <BRep_Tool.hxx>
+#include <OSD_Parallel.hxx>
+#include <Poly.hxx>
+#include <Poly_Triangulation.hxx>
+#include <TopoDS_Compound.hxx>
+#include <TShort_Array1OfShortReal.hxx>
+#include <algorithm>
+#include <cstdint>
+#include <numeric>
+#include <set>
+#include <vector>
+
+namespace dune3d {
+
+#if OCC_VERSION_MAJOR >= 7 && OCC_VERSION_MINOR >= 6
+#define HORIZON_NEW_OCC
+#endif
+
+static bool convert_face(const FaceToMesh &in)
+{
+    TopLoc_Location loc;
+    Handle(Poly_Triangulation) triangulation = BRep_Tool::Triangulation(in.face, loc);
+    if (triangulation.IsNull())
+        return false;
+
+#ifndef HORIZON_NEW_OCC
+    const TColgp_Array1OfPnt &arrPolyNodes = triangulation->Nodes();
+    const Poly_Array1OfTriangle &arrTriangles = triangulation->Triangles();
+    const TShort_Array1OfShortReal &arrNormals = triangulation->Normals();
+#endif
+
+    auto &face_out = *in.out;
+    const auto &mat = in.mat;
+    const size_t n_nodes = triangulation->NbNodes();
+
+    face_out.vertices.resize(n_nodes);
+    face_out.normals.resize(n_nodes);
+    for (size_t i = 0; i < n_nodes; i++) {
+#ifdef HORIZON_NEW_OCC
+        gp_XYZ v(triangulation->Node(i + 1).Coord());
+        const auto n = triangulation->Normal(i + 1);
+        const glm::dvec4 ng(n.X(), n.Y(), n.Z(), 0);
+#else
+        gp_XYZ v(arrPolyNodes(i + 1).Coord());
+        const auto offset = i * 3 + 1;
+        const glm::dvec4 ng(arrNormals(offset + 0), arrNormals(offset + 1), arrNormals(offset + 2), 0);
+#endif
+        const auto vt = mat * glm::dvec4(v.X(), v.Y(), v.Z(), 1);
+        face_out.vertices[i] = face::Vertex(vt.x, vt.y, vt.z);
+
+        const auto nt = glm::normalize(glm::dvec3(mat * ng));
+        face_out.normals[i] = face::Vertex(nt.x, nt.y, nt.z);
+    }
+
+    // average normals at coincident vertices, these end up next to each other once sorted
+    std::vector<uint32_t> order(n_nodes);
+    std::iota(order.begin(), order.end(), 0);
+    std::sort(order.begin(), order.end(),
+              [&face_out](uint32_t a, uint32_t b) { return face_out.vertices[a] < face_out.vertices[b]; });
+    for (size_t first = 0; first < order.size();) {
+        size_t last = first + 1;
+        while (last < order.size() && face_out.vertices[order[last]] == face_out.vertices[order[first]])
+            last++;
+        if (last - first > 1) {
+            glm::dvec3 n_acc(0, 0, 0);
+            for (size_t j = first; j < last; j++) {
+                const auto &n = face_out.normals[order[j]];
+                n_acc += glm::dvec3(n.x, n.y, n.z);
+            }
+            // opposing normals may cancel out, leave those alone
+            if (glm::length(n_acc) > 0) {
+                n_acc = glm::normalize(n_acc);
+                for (size_t j = first; j < last; j++)
+                    face_out.normals[order[j]] = face::Vertex(n_acc.x, n_acc.y, n_acc.z);
+            }
+        }
+        first = last;
+    }
+
+    face_out.triangle_indices.resize(triangulation->NbTriangles());
+    for (int i = 1; i <= triangulation->NbTriangles(); i++) {
+        int a, b, c;
+#ifdef HORIZON_NEW_OCC
+        triangulation->Triangle(i).Get(a, b, c);
+#else
+        arrTriangles(i).Get(a, b, c);
+#endif
+        face_out.triangle_indices[i - 1] = std::tuple<size_t, size_t, size_t>(a - 1, b - 1, c - 1);
+    }
+
+    return true;
+}
+
+void mesh_faces(std::span<FaceToMesh> faces, double deflection, double angle)
+{
+    if (faces.empty())
+        return;
+
+    {
+        TopoDS_Compound compound;
+        BRep_Builder builder;
+        builder.MakeCompound(compound);
+        for (const auto &it : faces)
+            builder.Add(compound, it.face);
+        // faces that already have a fine enough triangulation are left as they are
+        BRepMesh_IncrementalMesh mesh(compound, deflection, Standard_False, angle, Standard_True);
+    }
+
+    // faces may share their triangulation, so compute normals once per triangulation
+    std::vector<Handle(Poly_Triangulation)> triangulations;
+    {
+        std::set<const Poly_Triangulation *> seen;
+        for (const auto &it : faces) {
+            TopLoc_Location loc;
+            Handle(Poly_Triangulation) triangulation = BRep_Tool::Triangulation(it.face, loc);
+            if (!triangulation.IsNull() && seen.insert(triangulation.get()).second)
+                triangulations.push_back(triangulation);
+        }
+    }
+    OSD_Parallel::For(0, static_cast<int>(triangulations.size()),
+                      [&triangulations](int i) { Poly::ComputeNormals(triangulations.at(i)); });
+
+    OSD_Parallel::For(0, static_cast<int>(faces.size()), [&faces](int i) {
+        auto &it = faces[i];
+        it.ok = convert_face(it);
+    });
+}
+
+} // namespace dune3d
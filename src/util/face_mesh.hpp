@@ -0,0 +1,24 @@
+#pragma once
+#include "canvas/face.hpp"
+#include <TopoDS_Face.hxx>
+#include <glm/glm.hpp>
+#include <span>
+
+namespace dune3d {
+
+class FaceToMesh {
+public:
+    TopoDS_Face face;
+    // applied to vertices and normals
+    glm::dmat4 mat;
+    // gets vertices, normals and triangle indices, color is left alone
+    face::Face *out = nullptr;
+    // set if the face could be meshed
+    bool ok = false;
+};
+
+// Meshes all faces in a single parallel pass, then converts each face's
+// triangulation in parallel. Normals at coincident vertices get averaged.
+void mesh_faces(std::span<FaceToMesh> faces, double deflection, double angle);
+
+} // namespace dune3d
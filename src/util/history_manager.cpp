@@ -124,4 +124,12 @@ void HistoryManager::push(std::unique_ptr<const HistoryItem> it)
     m_signal_changed.emit();
 }
 
+void HistoryManager::replace_current(std::unique_ptr<const HistoryItem> it)
+{
+    if (!history_current)
+        throw std::runtime_error("no current history item");
+    history_current = std::move(it);
+    m_signal_changed.emit();
+}
+
 } // namespace dune3d
@@ -31,6 +31,7 @@ public:
     void set_never_forgets(bool x);
 
     void push(std::unique_ptr<const HistoryItem> it);
+    void replace_current(std::unique_ptr<const HistoryItem> it);
     void clear();
 
 private:
@@ -1,5 +1,9 @@
 #include "paths.hpp"
 #include <stdexcept>
+#include <cmath>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
 #include "document/entity/ientity_in_workplane.hpp"
 #include "document/entity/entity.hpp"
 #include "document/entity/entity_circle2d.hpp"
@@ -26,13 +30,58 @@ unsigned int Node::get_pt_for_edge(const Edge &edge) const
     throw std::runtime_error("not an edge of node");
 }
 
-static Node &get_or_create_node(std::list<Node> &nodes, const glm::dvec2 &p)
+// Finds the node at a point without looking at all nodes. Cells are as large as the
+// tolerance, so a matching node can only be in the point's cell or the ones around it.
+class NodeGrid {
+public:
+    NodeGrid(std::list<Node> &nodes) : m_nodes(nodes)
+    {
+    }
+
+    // points closer than the tolerance share a node, if there are several the first one created wins
+    Node &get_or_create(const glm::dvec2 &p);
+
+private:
+    static constexpr double s_tolerance = 1e-6;
+
+    std::list<Node> &m_nodes;
+    using Cell = std::pair<int64_t, int64_t>;
+    struct CellHash {
+        size_t operator()(const Cell &c) const
+        {
+            return std::hash<int64_t>{}(c.first) ^ (std::hash<int64_t>{}(c.second) * 0x9e3779b97f4a7c15ull);
+        }
+    };
+    // nodes are numbered in order of creation
+    std::unordered_map<Cell, std::vector<std::pair<size_t, Node *>>, CellHash> m_cells;
+    size_t m_n_nodes = 0;
+};
+
+Node &NodeGrid::get_or_create(const glm::dvec2 &p)
 {
-    for (auto &node : nodes) {
-        if (glm::length(node.p - p) < 1e-6)
-            return node;
+    if (!std::isfinite(p.x) || !std::isfinite(p.y))
+        return m_nodes.emplace_back(p);
+
+    const Cell cell{static_cast<int64_t>(std::floor(p.x / s_tolerance)),
+                    static_cast<int64_t>(std::floor(p.y / s_tolerance))};
+    const std::pair<size_t, Node *> *best = nullptr;
+    for (int64_t dx = -1; dx <= 1; dx++) {
+        for (int64_t dy = -1; dy <= 1; dy++) {
+            auto it = m_cells.find({cell.first + dx, cell.second + dy});
+            if (it == m_cells.end())
+                continue;
+            for (const auto &entry : it->second) {
+                if (glm::length(entry.second->p - p) < s_tolerance && (!best || entry.first < best->first))
+                    best = &entry;
+            }
+        }
     }
-    return nodes.emplace_back(p);
+    if (best)
+        return *best->second;
+
+    auto &node = m_nodes.emplace_back(p);
+    m_cells[cell].emplace_back(m_n_nodes++, &node);
+    return node;
 }
 
 
@@ -46,9 +95,9 @@ glm::dvec2 Paths::get_pt(const Entity &e, unsigned int pt, Edge::Transform tr)
         return p;
 }
 
-Edge::Edge(std::list<Node> &nodes, const Entity &e, Transform tr)
-    : from(get_or_create_node(nodes, Paths::get_pt(e, 1, tr))), to(get_or_create_node(nodes, Paths::get_pt(e, 2, tr))),
-      entity(e), transform_fn(tr)
+Edge::Edge(NodeGrid &nodes, const Entity &e, Transform tr)
+    : from(nodes.get_or_create(Paths::get_pt(e, 1, tr))), to(nodes.get_or_create(Paths::get_pt(e, 2, tr))), entity(e),
+      transform_fn(tr)
 {
     from.connected_edges.emplace(this, 1);
     to.connected_edges.emplace(this, 2);
@@ -96,24 +145,31 @@ static bool entity_is_valid(const Entity &en, Edge::Transform tr)
     return true;
 }
 
-Paths Paths::from_document(const Document &doc, const UUID &wrkpl_uu, const UUID &source_group_uu)
+Paths Paths::from_document(const Document &doc, const UUID &wrkpl_uu, const UUID &source_group_uu,
+                           const Document::ItemIndex *index)
 {
+    std::unique_ptr<Document::ItemIndex> own_index;
+    if (!index) {
+        own_index = std::make_unique<Document::ItemIndex>(doc);
+        index = own_index.get();
+    }
+    const auto &entities = index->get_entities(source_group_uu);
+
     Paths paths;
-    for (const auto &[uu, en] : doc.m_entities) {
-        if (en->m_group != source_group_uu)
-            continue;
+    NodeGrid node_grid{paths.nodes};
+    for (auto en : entities) {
         if (en->m_construction)
             continue;
         if (en->get_type() == Entity::Type::CIRCLE_2D)
             continue;
         if (en->get_type() == Entity::Type::POINT_2D)
             continue;
-        if (auto en_wrkpl = dynamic_cast<const IEntityInWorkplane *>(en.get())) {
+        if (auto en_wrkpl = dynamic_cast<const IEntityInWorkplane *>(en)) {
             if (en_wrkpl->get_workplane() != wrkpl_uu)
                 continue;
             if (!entity_is_valid(*en, [](const auto &x) { return x; }))
                 continue;
-            if (auto en_cluster = dynamic_cast<const EntityCluster *>(en.get())) {
+            if (auto en_cluster = dynamic_cast<const EntityCluster *>(en)) {
                 auto tr = [en_cluster](const glm::dvec2 &v) { return en_cluster->transform(v); };
                 for (const auto &[uu2, en2] : en_cluster->m_content->m_entities) {
                     if (en2->m_construction)
@@ -123,10 +179,10 @@ Paths Paths::from_document(const Document &doc, const UUID &wrkpl_uu, const UUID
                     if (en2->of_type(Entity::Type::CIRCLE_2D))
                         continue;
 
-                    paths.edges.emplace_back(paths.nodes, *en2, tr);
+                    paths.edges.emplace_back(node_grid, *en2, tr);
                 }
             }
-            else if (auto en_text = dynamic_cast<const EntityText *>(en.get())) {
+            else if (auto en_text = dynamic_cast<const EntityText *>(en)) {
                 auto tr = [en_text](const glm::dvec2 &v) { return en_text->transform(v); };
                 for (const auto &[uu2, en2] : en_text->m_content->m_entities) {
                     if (!entity_is_valid(*en2, tr))
@@ -134,11 +190,11 @@ Paths Paths::from_document(const Document &doc, const UUID &wrkpl_uu, const UUID
                     if (en2->of_type(Entity::Type::CIRCLE_2D))
                         continue;
 
-                    paths.edges.emplace_back(paths.nodes, *en2, tr);
+                    paths.edges.emplace_back(node_grid, *en2, tr);
                 }
             }
             else {
-                paths.edges.emplace_back(paths.nodes, *en, nullptr);
+                paths.edges.emplace_back(node_grid, *en, nullptr);
             }
         }
     }
@@ -195,9 +251,7 @@ Paths Paths::from_document(const Document &doc, const UUID &wrkpl_uu, const UUID
     }
 
     // add circles
-    for (const auto &[uu, en] : doc.m_entities) {
-        if (en->m_group != source_group_uu)
-            continue;
+    for (auto en : entities) {
         if (en->m_construction)
             continue;
         if (en->of_type(Entity::Type::CIRCLE_2D)) {
@@ -211,7 +265,7 @@ Paths Paths::from_document(const Document &doc, const UUID &wrkpl_uu, const UUID
             path.emplace_back(node, edge);
             paths.paths.emplace_back(std::move(path));
         }
-        else if (auto en_cluster = dynamic_cast<const EntityCluster *>(en.get())) {
+        else if (auto en_cluster = dynamic_cast<const EntityCluster *>(en)) {
             auto tr = [en_cluster](const glm::dvec2 &v) { return en_cluster->transform(v); };
             for (const auto &[uu2, en2] : en_cluster->m_content->m_entities) {
                 if (en2->m_construction)
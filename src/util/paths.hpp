@@ -5,13 +5,13 @@
 #include <functional>
 #include <deque>
 #include <glm/glm.hpp>
+#include "document/document.hpp"
 
 
 namespace dune3d {
 
 class Entity;
 class EntityCircle2D;
-class Document;
 class UUID;
 
 namespace paths {
@@ -28,10 +28,12 @@ public:
 };
 
 
+class NodeGrid;
+
 class Edge {
 public:
     using Transform = std::function<glm::dvec2(glm::dvec2)>;
-    Edge(std::list<Node> &nodes, const Entity &e, Transform tr);
+    Edge(NodeGrid &nodes, const Entity &e, Transform tr);
     Edge(Node &node, const EntityCircle2D &e, Transform tr);
     Node &from;
     Node &to;
@@ -46,7 +48,9 @@ using Path = std::deque<std::pair<Node &, Edge &>>;
 class Paths {
 public:
     std::deque<Path> paths;
-    static Paths from_document(const Document &doc, const UUID &wrkpl_uu, const UUID &source_group_uu);
+    // pass index when getting the paths of many groups, one is made otherwise
+    static Paths from_document(const Document &doc, const UUID &wrkpl_uu, const UUID &source_group_uu,
+                               const Document::ItemIndex *index = nullptr);
     static glm::dvec2 get_pt(const Entity &e, unsigned int pt, Edge::Transform tr);
 
 private:
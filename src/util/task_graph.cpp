@@ -0,0 +1,212 @@
+#include "task_graph.hpp"
+#include <algorithm>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+
+namespace dune3d {
+
+namespace {
+
+// Threads shared by all task graphs, so that running one doesn't need to start
+// threads. Idle threads just wait for jobs until TaskGraph::shutdown_threads.
+class ThreadPool {
+public:
+    static ThreadPool &get()
+    {
+        static auto pool = new ThreadPool(std::max(TaskGraph::get_default_n_threads(), 2u) - 1);
+        return *pool;
+    }
+
+    // jobs submitted after shutdown never run
+    void submit(std::function<void()> fn)
+    {
+        {
+            std::lock_guard<std::mutex> guard(m_mutex);
+            if (m_stop)
+                return;
+            m_jobs.push_back(std::move(fn));
+        }
+        m_cond.notify_one();
+    }
+
+    void shutdown()
+    {
+        std::vector<std::thread> threads;
+        {
+            std::lock_guard<std::mutex> guard(m_mutex);
+            m_stop = true;
+            m_jobs.clear();
+            threads = std::move(m_threads);
+        }
+        m_cond.notify_all();
+        for (auto &thread : threads)
+            thread.join();
+    }
+
+private:
+    explicit ThreadPool(unsigned int n_threads)
+    {
+        for (unsigned int i = 0; i < n_threads; i++) {
+            m_threads.emplace_back(&ThreadPool::worker, this);
+        }
+    }
+
+    void worker()
+    {
+        while (true) {
+            std::function<void()> fn;
+            {
+                std::unique_lock<std::mutex> lock(m_mutex);
+                m_cond.wait(lock, [this] { return m_stop || m_jobs.size(); });
+                if (m_stop)
+                    return;
+                fn = std::move(m_jobs.front());
+                m_jobs.pop_front();
+            }
+            fn();
+        }
+    }
+
+    std::mutex m_mutex;
+    std::condition_variable m_cond;
+    std::deque<std::function<void()>> m_jobs;
+    bool m_stop = false;
+    std::vector<std::thread> m_threads;
+};
+
+} // namespace
+
+struct TaskGraph::RunState {
+    std::mutex mutex;
+    std::condition_variable cond;
+    std::vector<unsigned int> n_deps;
+    std::deque<TaskID> ready;
+    size_t n_running = 0;
+    size_t n_done = 0;
+    bool stop = false;
+    std::exception_ptr exception;
+
+    // pool threads that joined in, run() only returns once they're done
+    unsigned int n_helpers = 0;
+    // helpers that get to run after this don't join in anymore
+    bool closed = false;
+};
+
+TaskGraph::TaskID TaskGraph::add_task(std::function<void()> fn)
+{
+    m_tasks.emplace_back().fn = std::move(fn);
+    return m_tasks.size() - 1;
+}
+
+void TaskGraph::add_dependency(TaskID task, TaskID depends_on)
+{
+    if (task == depends_on)
+        throw std::invalid_argument("task can't depend on itself");
+    auto &dep = m_tasks.at(depends_on);
+    for (auto it : dep.dependents) {
+        if (it == task)
+            return;
+    }
+    dep.dependents.push_back(task);
+    m_tasks.at(task).n_deps++;
+}
+
+unsigned int TaskGraph::get_default_n_threads()
+{
+    return std::max(std::thread::hardware_concurrency(), 1u);
+}
+
+void TaskGraph::shutdown_threads()
+{
+    ThreadPool::get().shutdown();
+}
+
+void TaskGraph::work(RunState &st, const CancelCheck &is_cancelled)
+{
+    std::unique_lock<std::mutex> lock(st.mutex);
+    while (true) {
+        st.cond.wait(lock, [&st] { return st.stop || st.ready.size() || (st.n_running == 0); });
+        if (st.stop || st.ready.empty())
+            return;
+        const auto id = st.ready.front();
+        st.ready.pop_front();
+        st.n_running++;
+        lock.unlock();
+
+        bool cancelled = false;
+        try {
+            if (is_cancelled && is_cancelled())
+                cancelled = true;
+            else
+                m_tasks.at(id).fn();
+        }
+        catch (...) {
+            lock.lock();
+            if (!st.exception)
+                st.exception = std::current_exception();
+            st.stop = true;
+            st.n_running--;
+            st.cond.notify_all();
+            return;
+        }
+
+        lock.lock();
+        st.n_running--;
+        st.n_done++;
+        if (cancelled)
+            st.stop = true;
+        for (auto dep : m_tasks.at(id).dependents) {
+            if (--st.n_deps.at(dep) == 0)
+                st.ready.push_back(dep);
+        }
+        st.cond.notify_all();
+    }
+}
+
+void TaskGraph::run(unsigned int n_threads, const CancelCheck &is_cancelled)
+{
+    auto st = std::make_shared<RunState>();
+    st->n_deps.reserve(m_tasks.size());
+    // lower IDs first, so that a single thread runs them in insertion order
+    for (TaskID i = 0; i < m_tasks.size(); i++) {
+        st->n_deps.push_back(m_tasks.at(i).n_deps);
+        if (m_tasks.at(i).n_deps == 0)
+            st->ready.push_back(i);
+    }
+
+    // the calling thread works on the tasks as well, so this also makes progress if
+    // all pool threads are busy, for example when running a task graph from a task
+    const auto n_helpers = std::min<size_t>(n_threads, m_tasks.size());
+    for (size_t i = 1; i < n_helpers; i++) {
+        ThreadPool::get().submit([this, st, &is_cancelled] {
+            {
+                std::lock_guard<std::mutex> guard(st->mutex);
+                if (st->closed)
+                    return;
+                st->n_helpers++;
+            }
+            work(*st, is_cancelled);
+            std::lock_guard<std::mutex> guard(st->mutex);
+            st->n_helpers--;
+            st->cond.notify_all();
+        });
+    }
+    work(*st, is_cancelled);
+    {
+        std::unique_lock<std::mutex> lock(st->mutex);
+        st->closed = true;
+        st->cond.wait(lock, [&st] { return st->n_helpers == 0; });
+    }
+
+    if (st->exception)
+        std::rethrow_exception(st->exception);
+    if (!st->stop && st->n_done != m_tasks.size())
+        throw std::runtime_error("task graph has a cycle");
+}
+
+} // namespace dune3d
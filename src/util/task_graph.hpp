@@ -0,0 +1,44 @@
+#pragma once
+#include <functional>
+#include <vector>
+#include <cstddef>
+
+namespace dune3d {
+
+// Runs a set of tasks on a couple of threads such that each task only starts
+// once all of its dependencies have finished. The threads come from a pool
+// shared by all task graphs.
+class TaskGraph {
+public:
+    using TaskID = size_t;
+    TaskID add_task(std::function<void()> fn);
+    void add_dependency(TaskID task, TaskID depends_on);
+
+    size_t size() const
+    {
+        return m_tasks.size();
+    }
+
+    using CancelCheck = std::function<bool()>;
+    // rethrows the first exception thrown by any task
+    void run(unsigned int n_threads, const CancelCheck &is_cancelled = nullptr);
+
+    static unsigned int get_default_n_threads();
+
+    // joins the pool's threads, needs to be called before the process exits,
+    // task graphs run afterwards only use the calling thread
+    static void shutdown_threads();
+
+private:
+    struct Task {
+        std::function<void()> fn;
+        std::vector<TaskID> dependents;
+        unsigned int n_deps = 0;
+    };
+    std::vector<Task> m_tasks;
+
+    struct RunState;
+    void work(RunState &st, const CancelCheck &is_cancelled);
+};
+
+} // namespace dune3d